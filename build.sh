@@ -23,6 +23,8 @@ cmake                                               \
   -DOMP_PARALLEL=ON                                 \
   -DMPI_PARALLEL=OFF                                \
   -DGPU_ACCELERATION=OFF                            \
+  -DLARGE_INDICES=OFF                               \
+  -DPERF_COUNTERS=OFF                               \
   $DIR
 
 # Run make
@@ -216,6 +216,24 @@ def set_boundary_condition_1D (model, T_in=T_CMB, T_out=T_CMB):
     return model
 
 
+def set_tuned_solver_parameters(model, tuned):
+    """
+    Setter for the solver parameters proposed by Model.tune_solver_parameters,
+    with tuned the parameters of the (e.g. subsampled) model that was tuned.
+    Since nrays and nquads are fixed by the rays and quadrature of a model, this
+    should be called in the setup of the new model, before set_uniform_rays and
+    set_quadrature.
+    """
+    if (tuned.tuned_nrays > 0):
+        model.parameters.set_nrays (tuned.tuned_nrays)
+    if (tuned.tuned_nquads > 0):
+        model.parameters.set_nquads(tuned.tuned_nquads)
+    # Set the parameters that do not depend on the model data
+    model.parameters.n_off_diag         = tuned.n_off_diag
+    model.parameters.max_width_fraction = tuned.max_width_fraction
+    return model
+
+
 def set_quadrature(model):
     """
     Setter for the quadrature roots and weights for the Gauss-Hermite
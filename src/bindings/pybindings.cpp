@@ -2,6 +2,7 @@
 
 #include "../configure.hpp"   // ../ is required!
 #include "tools/types.hpp"
+#include "tools/numa.hpp"
 #include "model/parameters/parameters.hpp"
 #include "io/cpp/io_cpp_text.hpp"
 #include "io/python/io_python.hpp"
@@ -28,6 +29,11 @@ PYBIND11_MODULE (core, module)
 
     module.def(    "n_threads_avail", &paracabs::multi_threading::    n_threads_avail);
     module.def("set_n_threads_avail", &paracabs::multi_threading::set_n_threads_avail);
+    module.def("set_thread_affinity", &set_thread_affinity);
+    module.def("perf_counters_enabled",  &perf_counters_enabled);
+    module.def("reset_perf_counters",    &reset_perf_counters);
+    module.def("get_perf_report_string", &get_perf_report_string, py::arg("per_thread") = false);
+    module.def("print_perf_report",      &print_perf_report,      py::arg("per_thread") = false);
 
     // Define vector types
     py::bind_vector<vector<LineProducingSpecies>> (module, "vLineProducingSpecies");
@@ -103,19 +109,28 @@ PYBIND11_MODULE (core, module)
         .def ("read",  (void (Model::*)(void))            &Model::read )
         .def ("write", (void (Model::*)(void) const)      &Model::write)
         .def ("read",  (void (Model::*)(const Io&))       &Model::read )
+        .def ("read",  (void (Model::*)(const Io&, const bool)) &Model::read )
         .def ("write", (void (Model::*)(const Io&) const) &Model::write)
         .def ("compute_inverse_line_widths",                                        &Model::compute_inverse_line_widths)
         .def ("compute_spectral_discretisation", (int (Model::*)(void            )) &Model::compute_spectral_discretisation)
         .def ("compute_spectral_discretisation", (int (Model::*)(const Real width)) &Model::compute_spectral_discretisation)
         .def ("compute_spectral_discretisation", (int (Model::*)(const long double nu_min, const long double nu_max)) &Model::compute_spectral_discretisation)
         .def ("compute_LTE_level_populations",                                      &Model::compute_LTE_level_populations)
+        .def ("compute_LVG_level_populations",                                      &Model::compute_LVG_level_populations)
+        .def ("compute_level_populations_from_model",                               &Model::compute_level_populations_from_model)
         // .def ("compute_radiation_field",                                            &Model::compute_radiation_field)
         .def ("compute_radiation_field_feautrier_order_2",                          &Model::compute_radiation_field_feautrier_order_2)
+        .def ("compute_radiation_field_feautrier_order_4",                          &Model::compute_radiation_field_feautrier_order_4)
+        .def ("compute_adaptive_rays",                                              &Model::compute_adaptive_rays)
         .def ("compute_radiation_field_shortchar_order_0",                          &Model::compute_radiation_field_shortchar_order_0)
         .def ("compute_Jeff",                                                       &Model::compute_Jeff)
         .def ("compute_level_populations_from_stateq",                              &Model::compute_level_populations_from_stateq)
         .def ("compute_level_populations",                                          &Model::compute_level_populations)
+        .def ("compute_level_populations_gauss_seidel",                             &Model::compute_level_populations_gauss_seidel)
+        .def ("compute_level_populations_incremental",                              &Model::compute_level_populations_incremental)
         .def ("compute_image",                                                      &Model::compute_image)
+        .def ("tune_solver_parameters",                                             &Model::tune_solver_parameters, py::arg("tolerance"), py::arg("max_niterations"), py::arg("subsample") = 1)
+        .def ("compute_image_shortchar_order_1",                                    &Model::compute_image_shortchar_order_1)
         .def ("set_eta_and_chi",                                                    &Model::set_eta_and_chi)
         .def ("set_boundary_condition",                                             &Model::set_boundary_condition)
         .def_readwrite ("eta",                &Model::eta)
@@ -129,7 +144,16 @@ PYBIND11_MODULE (core, module)
     py::class_<Parameters> (module, "Parameters")
         // io
         .def_readwrite ("n_off_diag",         &Parameters::n_off_diag)
+        .def_readwrite ("lambda_threshold",   &Parameters::lambda_threshold)
+        .def_readwrite ("lambda_max_entries", &Parameters::lambda_max_entries)
         .def_readwrite ("max_width_fraction", &Parameters::max_width_fraction)
+        .def_readwrite ("tau_max",            &Parameters::tau_max)
+        .def_readwrite ("ray_tolerance",      &Parameters::ray_tolerance)
+        .def_readwrite ("n_sweep_blocks",     &Parameters::n_sweep_blocks)
+        .def_readwrite ("store_intensities",     &Parameters::store_intensities)
+        .def_readwrite ("first_stage_shortchar", &Parameters::first_stage_shortchar)
+        .def_readwrite ("tuned_nquads",          &Parameters::tuned_nquads)
+        .def_readwrite ("tuned_nrays",           &Parameters::tuned_nrays)
         // setters
         .def ("set_model_name",               &Parameters::set_model_name          )
         .def ("set_dimension",                &Parameters::set_dimension           )
@@ -178,14 +202,18 @@ PYBIND11_MODULE (core, module)
     // Geometry
     py::class_<Geometry> (module, "Geometry")
         // attributes
-        .def_readwrite ("points",   &Geometry::points)
-        .def_readwrite ("rays",     &Geometry::rays)
-        .def_readwrite ("boundary", &Geometry::boundary)
-        .def_readwrite ("lengths",  &Geometry::lengths)
+        .def_readwrite ("points",                   &Geometry::points)
+        .def_readwrite ("rays",                     &Geometry::rays)
+        .def_readwrite ("boundary",                 &Geometry::boundary)
+        .def_readwrite ("lengths",                  &Geometry::lengths)
+        .def_readwrite ("use_successors",           &Geometry::use_successors)
+        .def_readwrite ("use_projected_velocities", &Geometry::use_projected_velocities)
         // io
-        .def ("read",               &Geometry::read)
-        .def ("write",              &Geometry::write)
+        .def ("read",                               &Geometry::read)
+        .def ("write",                              &Geometry::write)
         // functions
+        .def ("set_successors",                     &Geometry::set_successors)
+        .def ("set_projected_velocities",           &Geometry::set_projected_velocities)
         // .def ("get_ray_lengths",     &Geometry::get_ray_lengths)
         // .def ("get_ray_lengths_gpu", &Geometry::get_ray_lengths_gpu)
         // constructor
@@ -215,6 +243,8 @@ PYBIND11_MODULE (core, module)
         .def_readwrite ("direction", &Rays::direction)
         .def_readwrite ("antipod",   &Rays::antipod)
         .def_readwrite ("weight",    &Rays::weight)
+        .def_readwrite ("point_weight", &Rays::point_weight)
+        .def_readwrite ("adaptive",     &Rays::adaptive)
         .def ("print",    &Rays::print)
         // io
         .def ("read",                &Rays::read)
@@ -314,7 +344,8 @@ PYBIND11_MODULE (core, module)
         .def_readwrite ("inverse_width",        &Lines::inverse_width)
         .def_readwrite ("line",                 &Lines::line)
         // functions
-        .def ("read",                           &Lines::read)
+        .def ("read",                           (void (Lines::*)(const Io&)) &Lines::read)
+        .def ("read_deferred_data",             &Lines::read_deferred_data)
         .def ("write",                          &Lines::write)
         .def ("set_emissivity_and_opacity",     &Lines::set_emissivity_and_opacity)
         // constructor
@@ -341,7 +372,8 @@ PYBIND11_MODULE (core, module)
         .def_readwrite ("LambdaStar",       &LineProducingSpecies::LambdaStar)
         .def_readwrite ("LambdaTest",       &LineProducingSpecies::LambdaTest)
         // functions
-        .def ("read",                       &LineProducingSpecies::read)
+        .def ("read",                       (void (LineProducingSpecies::*)(const Io&, const Size)) &LineProducingSpecies::read)
+        .def ("read_deferred_data",         &LineProducingSpecies::read_deferred_data)
         .def ("write",                      &LineProducingSpecies::write)
         .def ("index",                      &LineProducingSpecies::index)
         // constructor
@@ -356,8 +388,12 @@ PYBIND11_MODULE (core, module)
         // .def_readwrite ("size", &Lambda::size)
         .def_readwrite ("Lss",  &Lambda::Lss)
         .def_readwrite ("nrs",  &Lambda::nrs)
+        .def_readwrite ("n_dropped", &Lambda::n_dropped)
         // functions
-        .def ("add_element",    &Lambda::add_element)
+        .def ("add_element",    (void (Lambda::*)(const Size, const Size, const Size, const Real            )) &Lambda::add_element)
+        .def ("add_element",    (void (Lambda::*)(const Size, const Size, const Size, const Real, const Size)) &Lambda::add_element)
+        .def ("get_n_elements", &Lambda::get_n_elements)
+        .def ("get_n_dropped",  &Lambda::get_n_dropped)
         .def ("linearize_data", &Lambda::linearize_data)
         .def ("MPI_gather",     &Lambda::MPI_gather)
         // constructor
@@ -395,7 +431,7 @@ PYBIND11_MODULE (core, module)
         .def_readwrite ("ncolpar",      &Linedata::ncolpar)
         .def_readwrite ("colpar",       &Linedata::colpar)
         // functions
-        .def ("read",                   &Linedata::read)
+        .def ("read",                   (void (Linedata::*)(const Io&, const Size)) &Linedata::read)
         .def ("write",                  &Linedata::write)
         // constructor
         .def (py::init<>());
@@ -550,6 +586,36 @@ PYBIND11_MODULE (core, module)
         .def (py::init());
 
 
+    // Tensor <Size>
+    py::class_<Tensor<Size>, Vector<Size>> (module, "TSize", py::buffer_protocol())
+        // buffer
+        .def_buffer(
+            [](Tensor<Size> &t) -> py::buffer_info
+            {
+                return py::buffer_info(
+                    t.vec.data(),                                                        // Pointer to buffer
+                    sizeof(Size),                                                        // Size of one element
+                    py::format_descriptor<Size>::format(),                               // Python struct-style format descriptor
+                    3,                                                                   // Number of dimensions
+                    py::detail::any_container<ssize_t>({t.nrows,
+                                                        t.ncols,
+                                                        t.depth }),                      // Buffer dimensions
+                    py::detail::any_container<ssize_t>({sizeof(Size)*t.ncols*t.depth,
+                                                        sizeof(Size)*t.depth,
+                                                        sizeof(Size)                 })   // Strides (in bytes) for each index
+                );
+            }
+        )
+        .def_readwrite ("vec",   &Vector<Size>::vec)
+        .def_readwrite ("nrows", &Tensor<Size>::nrows)
+        .def_readwrite ("ncols", &Tensor<Size>::ncols)
+        .def_readwrite ("depth", &Tensor<Size>::depth)
+        // functions
+        .def ("set", &Tensor<Size>::set_3D_array)
+        // constructor
+        .def (py::init());
+
+
     // Vector <Vector3D>
     py::class_<Vector<Vector3D>> (module, "VVector3D", py::buffer_protocol())
         // buffer
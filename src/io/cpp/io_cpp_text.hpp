@@ -13,6 +13,10 @@ struct IoText : public Io
     // Constructor
     IoText (const string &io_file);
 
+    std::shared_ptr<const Io> clone () const override {return std::make_shared<IoText> (*this);}
+
+    bool is_thread_safe () const override {return true;}
+
     int  read_length   (const string fname,       Size    &length) const override;
     Size  get_length   (const string fname                       ) const override;
 
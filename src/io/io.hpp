@@ -1,6 +1,8 @@
 #pragma once
 
 
+#include <memory>
+
 #include "tools/types.hpp"
 
 
@@ -14,6 +16,14 @@ struct Io
     // Constructor
     Io (const string &io_file): io_file (io_file) {};
 
+    virtual ~Io () {};
+
+    ///  Copy of this io object (kept to read deferred data later on)
+    virtual std::shared_ptr<const Io> clone () const = 0;
+
+    ///  Whether different sections can be read concurrently
+    virtual bool is_thread_safe () const {return false;}
+
     virtual int  read_length   (const string fname,       Size    &length) const = 0;
     virtual Size  get_length   (const string fname                       ) const = 0;
 
@@ -16,6 +16,8 @@ struct IoPython : public Io
         // Constructor
         IoPython (const string &implementation, const string &io_file);
 
+        std::shared_ptr<const Io> clone () const override {return std::make_shared<IoPython> (*this);}
+
         int  read_length   (const string fname,       Size    &length) const override;
         Size  get_length   (const string fname                       ) const override;
 
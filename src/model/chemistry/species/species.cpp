@@ -14,18 +14,22 @@ void Species :: read (const Io& io)
     parameters.set_nspecs  (io.get_length (prefix+"species"  ));
     parameters.set_npoints (io.get_length (prefix+"abundance"));
 
-    abundance_init.resize (parameters.npoints());
-    abundance     .resize (parameters.npoints());
+    abundance_init.resize (parameters.npoints(), parameters.nspecs());
+    abundance     .resize (parameters.npoints(), parameters.nspecs());
+
+    Double2 abundance_buffer (parameters.npoints(), Double1 (parameters.nspecs()));
+
+    // Read the abundaces of each species in each cell
+    io.read_array (prefix+"abundance", abundance_buffer);
 
     for (Size p = 0; p < parameters.npoints(); p++)
     {
-      abundance_init[p].resize (parameters.nspecs());
-      abundance     [p].resize (parameters.nspecs());
+        for (Size s = 0; s < parameters.nspecs(); s++)
+        {
+            abundance(p,s) = abundance_buffer[p][s];
+        }
     }
 
-    // Read the abundaces of each species in each cell
-    io.read_array (prefix+"abundance", abundance);
-
     // Set initial abundances
     abundance_init = abundance;
 }
@@ -40,6 +44,16 @@ void Species :: write (const Io &io) const
 
     Long1 dummy (parameters.nspecs(), 0);
 
-    io.write_list  (prefix+"species",   dummy    );
-    io.write_array (prefix+"abundance", abundance);
+    Double2 abundance_buffer (parameters.npoints(), Double1 (parameters.nspecs()));
+
+    for (Size p = 0; p < parameters.npoints(); p++)
+    {
+        for (Size s = 0; s < parameters.nspecs(); s++)
+        {
+            abundance_buffer[p][s] = abundance(p,s);
+        }
+    }
+
+    io.write_list  (prefix+"species",   dummy           );
+    io.write_array (prefix+"abundance", abundance_buffer);
 }
@@ -14,8 +14,8 @@ struct Species
 
     String1 symbol;
 
-    Double2 abundance_init;   ///< abundance before chemical evolution
-    Double2 abundance;        ///< (current) abundance in every cell
+    Matrix<Real> abundance_init;   ///< abundance before chemical evolution (p, s)
+    Matrix<Real> abundance;        ///< (current) abundance in every cell   (p, s)
 
     void read  (const Io& io);
     void write (const Io& io) const;
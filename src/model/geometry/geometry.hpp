@@ -26,6 +26,13 @@ struct Geometry
     Matrix<Size> lengths;
     Size         lengths_max;
 
+    Matrix<Size>  successor;               ///< next point along each ray direction   (r, p), 4 bytes each
+    Matrix<float> successor_dZ;            ///< corresponding distance increment      (r, p), 4 bytes each
+    bool          use_successors = false;  ///< trace approximately using the successor graph
+
+    Matrix<float> v_projected;                       ///< velocity projected on ray direction (r, p)
+    bool          use_projected_velocities = false;  ///< compute shifts from v_projected
+
     void read  (const Io& io);
     void write (const Io& io) const;
 
@@ -52,6 +59,12 @@ struct Geometry
               double& Z,
               double& dZ  ) const;
 
+    accel inline Size get_next_successor (
+        const Size    r,
+        const Size    crt,
+              double& Z,
+              double& dZ  ) const;
+
     accel inline Size get_next_spherical_symmetry (
         const Size    o,
         const Size    r,
@@ -93,6 +106,9 @@ struct Geometry
     // template <Frame frame>
     // inline void get_ray_lengths (const double dshift_max);
 
+    inline void set_successors ();
+    inline void set_projected_velocities ();
+
     inline bool valid_point     (const Size p) const;
     inline bool not_on_boundary (const Size p) const;
 };
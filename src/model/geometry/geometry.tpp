@@ -52,6 +52,32 @@ accel inline Size Geometry :: get_next_general_geometry (
 }
 
 
+///  Getter for the number of the next cell on ray and its distance along ray from
+///  the precomputed successor graph. This is approximate, since the successor of
+///  a point does not depend on the origin of the ray (see set_successors).
+///    @param[in]      r : number of the ray along which we are looking
+///    @param[in]      c : number of the cell put last on the ray
+///    @param[in/out]  Z : reference to the current distance along the ray
+///    @param[out]    dZ : reference to the distance increment to the next ray
+///    @return number of the next cell on the ray after the current cell
+///////////////////////////////////////////////////////////////////////////////////
+accel inline Size Geometry :: get_next_successor (
+    const Size    r,
+    const Size    c,
+          double& Z,
+          double& dZ  ) const
+{
+    const Size next = successor(r,c);
+
+    dZ = successor_dZ(r,c);
+
+    // Update distance along ray
+    Z += dZ;
+
+    return next;
+}
+
+
 ///  Getter for the number of the next cell on ray and its distance along ray when
 ///  assuming spherical symmetry and such that the positions are in ascending order!
 ///    @param[in]      o : number of cell from which the ray originates
@@ -126,6 +152,11 @@ inline double Geometry :: get_shift_general_geometry <CoMoving> (
     const Size  r,
     const Size  crt ) const
 {
+    if (use_projected_velocities)
+    {
+        return 1.0 - (v_projected(r,crt) - v_projected(r,o));
+    }
+
     return 1.0 - (points.velocity[crt] - points.velocity[o]).dot(rays.direction[r]);
 }
 
@@ -149,6 +180,11 @@ inline double Geometry :: get_shift_general_geometry <Rest> (
         r_correct = rays.antipod[r];
     }
 
+    if (use_projected_velocities)
+    {
+        return 1.0 - v_projected(r_correct,crt);
+    }
+
     return 1.0 - points.velocity[crt].dot(rays.direction[r_correct]);
 }
 
@@ -207,6 +243,62 @@ accel inline Size Geometry :: get_ray_length (
 }
 
 
+///  Setter for the successor graph used by the approximate tracer. For every ray
+///  direction, the successor of a point is the next point on a ray with the same
+///  direction originating in that point. Tracing then only requires looking up
+///  successors. The table stores a Size and a float per (ray, point), i.e. it
+///  takes npoints x nrays x 8 bytes (e.g. 3.2 GB for 10^6 points and 400 rays).
+///  Only suited for (nearly) regular grids: there the rays are the exact ones,
+///  on an unstructured mesh (random points, 16 nearest neighbours) the mean
+///  intensity was found to differ 12% on average (up to a factor 7) from the
+///  exact tracer, since successors do not depend on the origin of the ray.
+/////////////////////////////////////////////////////////////////////////////////
+inline void Geometry :: set_successors ()
+{
+    successor   .resize (parameters.nrays(), parameters.npoints());
+    successor_dZ.resize (parameters.nrays(), parameters.npoints());
+
+    for (Size r = 0; r < parameters.nrays(); r++)
+    {
+        threaded_for (p, parameters.npoints(),
+        {
+            double  Z = 0.0;
+            double dZ = 0.0;
+
+            successor   (r,p) = get_next_general_geometry (p, r, p, Z, dZ);
+            successor_dZ(r,p) = dZ;
+        })
+    }
+
+    successor   .copy_ptr_to_vec();
+    successor_dZ.copy_ptr_to_vec();
+
+    use_successors = true;
+}
+
+
+///  Setter for the table of velocities projected on the ray directions, such
+///  that a Doppler shift only requires two scalar loads. Note that the table
+///  has to be set again whenever the velocities change.
+/////////////////////////////////////////////////////////////////////////////
+inline void Geometry :: set_projected_velocities ()
+{
+    v_projected.resize (parameters.nrays(), parameters.npoints());
+
+    for (Size r = 0; r < parameters.nrays(); r++)
+    {
+        threaded_for (p, parameters.npoints(),
+        {
+            v_projected(r,p) = points.velocity[p].dot(rays.direction[r]);
+        })
+    }
+
+    v_projected.copy_ptr_to_vec();
+
+    use_projected_velocities = true;
+}
+
+
 // inline Size1 Geometry :: get_ray_lengths ()
 // {
 //     for (Size rr = 0; rr < parameters.hnrays(); rr++)
@@ -291,6 +383,10 @@ accel inline Size Geometry :: get_next (
     {
         next = get_next_spherical_symmetry (o, r, crt, Z, dZ);
     }
+    else if (use_successors)
+    {
+        next = get_next_successor          (   r, crt, Z, dZ);
+    }
     else
     {
         next = get_next_general_geometry   (o, r, crt, Z, dZ);
@@ -1,9 +1,73 @@
 #include "rays.hpp"
+#include "tools/constants.hpp"
 
 
 const string prefix = "geometry/rays/";
 
 
+///  Direction of the centre of a pixel in the nested HEALPix scheme
+///  (following pix2vec_nest of Gorski et al. 2005, ApJ 622, 759)
+///    @param[in] order : HEALPix order (nside = 2^order)
+///    @param[in] pixel : index of the nested pixel
+///    @return unit vector pointing to the centre of the pixel
+/////////////////////////////////////////////////////////////////////
+inline Vector3D healpix_nest2vec (const Size order, const Size pixel)
+{
+    const long jrll[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+    const long jpll[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
+
+    const long nside  = 1L << order;
+    const long npface = nside * nside;
+    const long face   = pixel >> (2*order);
+    const long ipf    = pixel & (npface-1);
+
+    // De-interleave the bits of the index in the face
+    long ix = 0;
+    long iy = 0;
+
+    for (Size b = 0; b < order; b++)
+    {
+        ix |= ((ipf >> (2*b  )) & 1L) << b;
+        iy |= ((ipf >> (2*b+1)) & 1L) << b;
+    }
+
+    const long jr = jrll[face]*nside - ix - iy - 1;
+
+    long   nr;
+    long   kshift;
+    double z;
+
+    if      (jr < nside)
+    {
+        nr     = jr;
+        z      = 1.0 - nr*nr / (3.0*npface);
+        kshift = 0;
+    }
+    else if (jr > 3*nside)
+    {
+        nr     = 4*nside - jr;
+        z      = nr*nr / (3.0*npface) - 1.0;
+        kshift = 0;
+    }
+    else
+    {
+        nr     = nside;
+        z      = (2*nside - jr) * 2.0 / (3.0*nside);
+        kshift = (jr - nside) & 1;
+    }
+
+    long jp = (jpll[face]*nr + ix - iy + 1 + kshift) / 2;
+
+    if (jp > 4*nside) {jp -= 4*nside;}
+    if (jp < 1      ) {jp += 4*nside;}
+
+    const double phi = (jp - 0.5*(kshift+1)) * (0.5*PI / nr);
+    const double sth = sqrt ((1.0-z) * (1.0+z));
+
+    return Vector3D (sth*cos(phi), sth*sin(phi), z);
+}
+
+
 void Rays :: read (const Io& io)
 {
     cout << "Reading rays..." << endl;
@@ -46,6 +110,90 @@ void Rays :: read (const Io& io)
 }
 
 
+///  Setter for the nested HEALPix hierarchy of the ray directions, i.e. the
+///  nested pixel of each ray and, for each pixel of each (lower) order, the ray
+///  closest to its centre. The ray of the antipodal pixel is always the antipode
+///  of that ray, such that a pixel and its antipode form a ray pair.
+///  Throws if the rays are not HEALPix directions (in any ordering).
+/////////////////////////////////////////////////////////////////////////////////
+void Rays :: set_nested_rays ()
+{
+    const Size nrays = parameters.nrays();
+
+    order = 0;
+
+    while (12*(Size(1) << (2*order)) < nrays) {order++;}
+
+    if (12*(Size(1) << (2*order)) != nrays)
+    {
+        throw std::runtime_error ("The number of rays is not a HEALPix number (12 4^order)!");
+    }
+
+    const double tolerance = 1.0E-9;
+
+    nested_pixel.resize (nrays);
+
+    for (Size q = 0; q < nrays; q++)
+    {
+        const Vector3D centre = healpix_nest2vec (order, q);
+
+        Size r = 0;
+
+        while ((r < nrays) && ((direction[r] - centre).squaredNorm() >= tolerance)) {r++;}
+
+        if (r == nrays)
+        {
+            throw std::runtime_error ("The rays are not HEALPix directions!");
+        }
+
+        nested_pixel[r] = q;
+    }
+
+    nested_ray.resize (order+1);
+
+    for (Size l = 0; l <= order; l++)
+    {
+        const Size npixels = 12*(Size(1) << (2*l));
+        const Size shift   = 2*(order-l);
+
+        nested_ray[l].assign (npixels, nrays);
+
+        for (Size r = 0; r < nrays; r++)
+        {
+            const Size q = nested_pixel[r] >> shift;
+
+            if (nested_ray[l][q] == nrays)
+            {
+                nested_ray[l][q] = r;
+            }
+        }
+
+        for (Size q = 0; q < npixels; q++)
+        {
+            const Vector3D centre = healpix_nest2vec (l, q);
+
+            // Only start from one pixel of each antipodal pair
+            if (nested_pixel[antipod[nested_ray[l][q]]] >> shift < q) {continue;}
+
+            Size   r_best = nrays;
+            double d_best = 0.0;
+
+            for (Size r = 0; r < nrays; r++)
+            {
+                if ((nested_pixel[r] >> shift == q) && ((r_best == nrays) || ((direction[r] - centre).squaredNorm() < d_best)))
+                {
+                    r_best = r;
+                    d_best = (direction[r] - centre).squaredNorm();
+                }
+            }
+
+            nested_ray[l][q] = r_best;
+            nested_ray[l][nested_pixel[antipod[r_best]] >> shift] = antipod[r_best];
+        }
+    }
+}
+
+
 void Rays :: write (const Io& io) const
 {
     cout << "Writing rays..." << endl;
@@ -14,9 +14,33 @@ struct Rays
     Vector<Size>     antipod;
     Vector<Real>     weight;
 
+    Matrix<Real> point_weight;       ///< weight of ray pair rr in point p with adaptive rays (hnrays, npoints)
+    bool         adaptive = false;   ///< use the point_weight, instead of the weight of the ray
+
+    Size  order;                     ///< HEALPix order of the ray directions
+    Size1 nested_pixel;              ///< nested HEALPix pixel (of the ray order) of each ray
+    Size2 nested_ray;                ///< ray closest to the centre of each nested pixel (order, pixel)
+
     void read  (const Io& io);
     void write (const Io& io) const;
 
+    void set_nested_rays ();
+
+    ///  Getter for the angular weight of ray r in point p
+    ///    @param[in] p : index of the point
+    ///    @param[in] r : index of the ray
+    ///    @return weight of the ray (0 if it is not traced in p with adaptive rays)
+    ///////////////////////////////////////////////////////////////////////////////
+    accel inline Real get_weight (const Size p, const Size r) const
+    {
+        if (adaptive)
+        {
+            return point_weight ((r < parameters.hnrays()) ? r : antipod[r], p);
+        }
+
+        return weight[r];
+    }
+
     void print()
     {
         for (Size r = 0; r < parameters.nrays(); r++)
@@ -16,22 +16,32 @@ struct Lambda
 
     Size1 size;
 
+    Size1 n_dropped;   ///< number of dropped contributions and elements (per receiving cell)
+
     Size  nrad;   ///< number of (radiative) transitions
 
     inline void initialize (const Size nrad_new);
     inline void clear ();
+    inline void clear (const Size p);
     inline void linearize_data ();
 
     inline void MPI_gather ();
 
-    inline Size index_first (const Size p, const Size k) const;
-    inline Size index_last  (const Size p, const Size k) const;
+    inline Index index_first (const Size p, const Size k) const;
+    inline Index index_last  (const Size p, const Size k) const;
 
     inline Real get_Ls   (const Size p, const Size k, const Size index) const;
     inline Size get_nr   (const Size p, const Size k, const Size index) const;
     inline Size get_size (const Size p, const Size k) const;
 
     inline void add_element (const Size p, const Size k, const Size nr, const Real Ls);
+    inline void add_element (const Size p, const Size k, const Size nr, const Real Ls, const Size max_size);
+
+    inline void prune (const Real threshold);
+
+    inline Index get_n_elements () const;
+    inline Index get_n_dropped  () const;
+    inline void  print_statistics () const;
 };
 
 
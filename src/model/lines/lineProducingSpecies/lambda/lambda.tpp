@@ -2,14 +2,18 @@ inline void Lambda :: initialize (const Size nrad_new)
 {
     nrad = nrad_new;
 
-    Lss.reserve (parameters.npoints() * nrad);
-    nrs.reserve (parameters.npoints() * nrad);
+    const Index nind = ((Index) parameters.npoints()) * nrad;
 
-    size.resize (parameters.npoints() * nrad);
+    Lss.reserve (nind);
+    nrs.reserve (nind);
+
+    size.resize (nind);
 
     Ls.resize (parameters.npoints());
     nr.resize (parameters.npoints());
 
+    n_dropped.resize (parameters.npoints(), 0);
+
     for (Size p = 0; p < parameters.npoints(); p++)
     {
         Ls[p].resize (nrad);
@@ -36,17 +40,34 @@ inline void Lambda :: clear ()
             Ls[p][k].clear();
             nr[p][k].clear();
         }
+
+        n_dropped[p] = 0;
     })
 }
 
 
+///  Clear the ALO elements of a single (receiving) cell
+///    @param[in] p : index of the receiving cell
+/////////////////////////////////////////////////////
+inline void Lambda :: clear (const Size p)
+{
+    for (Size k = 0; k < nrad; k++)
+    {
+        Ls[p][k].clear();
+        nr[p][k].clear();
+    }
+
+    n_dropped[p] = 0;
+}
+
+
 /// Index of the first element belonging to p and k
 ///    @param[in] p : index of the receiving cell
 ///    @param[in] k : index of the line transition
 ///////////////////////////////////////////////////
-inline Size Lambda :: index_first (const Size p, const Size k) const
+inline Index Lambda :: index_first (const Size p, const Size k) const
 {
-    return k + nrad*p;
+    return k + ((Index) nrad)*p;
 }
 
 
@@ -54,7 +75,7 @@ inline Size Lambda :: index_first (const Size p, const Size k) const
 ///    @param[in] p : index of the receiving cell
 ///    @param[in] k : index of the line transition
 //////////////////////////////////////////////////
-inline Size Lambda :: index_last (const Size p, const Size k) const
+inline Index Lambda :: index_last (const Size p, const Size k) const
 {
     return index_first(p,k) + get_size(p,k) - 1;
 }
@@ -115,18 +136,151 @@ inline void Lambda :: add_element (const Size p, const Size k, const Size nr_new
 }
 
 
+///  Setter for an ALO element, keeping at most max_size elements for p and k.
+///  When full, a new element replaces the smallest off-diagonal element if it
+///  is larger, otherwise it is dropped (either way one contribution is lost).
+///    @param[in] p        : index of the receiving cell
+///    @param[in] k        : index of the line transition
+///    @param[in] nr_new   : index of the emitting cell
+///    @param[in] Ls_new   : new element of the ALO
+///    @param[in] max_size : maximum number of elements (0 = no limit)
+///////////////////////////////////////////////////////////////////////////////
+inline void Lambda :: add_element (const Size p, const Size k, const Size nr_new, const Real Ls_new, const Size max_size)
+{
+    for (Size index = 0; index < nr[p][k].size(); index++)
+    {
+        if (nr[p][k][index] == nr_new)
+        {
+            Ls[p][k][index] += Ls_new;
+            return;
+        }
+    }
+
+    if ((max_size == 0) || (nr[p][k].size() < max_size))
+    {
+        Ls[p][k].push_back (Ls_new);
+        nr[p][k].push_back (nr_new);
+        return;
+    }
+
+    // Find the smallest off-diagonal element (the diagonal is always kept)
+    Size index_min = nr[p][k].size();
+
+    for (Size index = 0; index < nr[p][k].size(); index++)
+    {
+        if (   (nr[p][k][index] != p)
+            && ((index_min == nr[p][k].size()) || (fabs (Ls[p][k][index]) < fabs (Ls[p][k][index_min]))))
+        {
+            index_min = index;
+        }
+    }
+
+    if ((index_min < nr[p][k].size()) && (fabs (Ls_new) > fabs (Ls[p][k][index_min])))
+    {
+        Ls[p][k][index_min] = Ls_new;
+        nr[p][k][index_min] = nr_new;
+    }
+
+    n_dropped[p]++;
+}
+
+
+///  Remove the (accumulated) off-diagonal ALO elements with a magnitude below
+///  threshold times the diagonal element of the same cell and transition
+///    @param[in] threshold : relative magnitude below which elements are removed
+//////////////////////////////////////////////////////////////////////////////
+inline void Lambda :: prune (const Real threshold)
+{
+    threaded_for (p, parameters.npoints(),
+    {
+        for (Size k = 0; k < nrad; k++)
+        {
+            Real L_diag = 0.0;
+
+            for (Size index = 0; index < nr[p][k].size(); index++)
+            {
+                if (nr[p][k][index] == p) {L_diag = fabs (Ls[p][k][index]);}
+            }
+
+            Size n_kept = 0;
+
+            for (Size index = 0; index < nr[p][k].size(); index++)
+            {
+                if ((nr[p][k][index] == p) || (fabs (Ls[p][k][index]) >= threshold * L_diag))
+                {
+                    Ls[p][k][n_kept] = Ls[p][k][index];
+                    nr[p][k][n_kept] = nr[p][k][index];
+
+                    n_kept++;
+                }
+            }
+
+            n_dropped[p] += nr[p][k].size() - n_kept;
+
+            Ls[p][k].resize (n_kept);
+            nr[p][k].resize (n_kept);
+        }
+    })
+}
+
+
+///  Getter for the total number of ALO elements
+////////////////////////////////////////////////
+inline Index Lambda :: get_n_elements () const
+{
+    Index n_elements = 0;
+
+    for (Size p = 0; p < parameters.npoints(); p++)
+    {
+        for (Size k = 0; k < nrad; k++)
+        {
+            n_elements += nr[p][k].size();
+        }
+    }
+
+    return n_elements;
+}
+
+
+///  Getter for the total number of dropped contributions to the ALO
+////////////////////////////////////////////////////////////////////
+inline Index Lambda :: get_n_dropped () const
+{
+    Index n_dropped_tot = 0;
+
+    for (Size p = 0; p < parameters.npoints(); p++)
+    {
+        n_dropped_tot += n_dropped[p];
+    }
+
+    return n_dropped_tot;
+}
+
+
+///  Print the number of kept ALO elements and dropped contributions
+/////////////////////////////////////////////////////////////////////
+inline void Lambda :: print_statistics () const
+{
+    const Index n_elements = get_n_elements ();
+
+    cout << "Lambda: kept " << n_elements << " elements ("
+         << ((double) n_elements) / (((double) parameters.npoints()) * nrad)
+         << " per point and transition), dropped " << get_n_dropped() << " contributions and elements" << endl;
+}
+
+
 
 
 inline void Lambda :: linearize_data ()
 {
-    Size size_total = 0;
+    Index size_total = 0;
 
 #   pragma omp parallel for reduction (+: size_total)
     for (Size p = 0; p < parameters.npoints(); p++)
     {
         for (Size k = 0; k < nrad; k++)
         {
-            const Size index = index_first (p,k);
+            const Index index = index_first (p,k);
 
             size[index] = nr[p][k].size();
             size_total += size[index];
@@ -136,7 +290,7 @@ inline void Lambda :: linearize_data ()
     Lss.resize (size_total);
     nrs.resize (size_total);
 
-    Size index = 0;
+    Index index = 0;
 
     for (Size p = 0; p < parameters.npoints(); p++)
     {
@@ -10,51 +10,54 @@ const string prefix = "lines/lineProducingSpecies_";
 ////////////////////////////////////////////////////////////////
 void LineProducingSpecies :: read (const Io& io, const Size l)
 {
-    cout << "Reading lineProducingSpecies..." << endl;
+    read (io, l, false);
+}
 
-    linedata  .read (io, l);
-    quadrature.read (io, l);
 
+///  Reader for the LineProducingSpecies data from the Io object
+///  With lazy loading, the previous populations and the collision partners
+///  are only read on first use (see read_deferred_data).
+///    @param[in] io   : io object
+///    @param[in] l    : nr of line producing species
+///    @param[in] lazy : true to defer reading the optional data
+///////////////////////////////////////////////////////////////////////////
+void LineProducingSpecies :: read (const Io& io, const Size l, const bool lazy)
+{
+    cout << "Reading lineProducingSpecies..." << endl;
 
-    RT        .resize (parameters.npoints()*linedata.nlev,
-                       parameters.npoints()*linedata.nlev );
-    LambdaStar.resize (parameters.npoints()*linedata.nlev,
-                       parameters.npoints()*linedata.nlev );
-    LambdaTest.resize (parameters.npoints()*linedata.nlev,
-                       parameters.npoints()*linedata.nlev );
+    linedata  .read (io, l, lazy);
+    quadrature.read (io, l);
 
-    lambda.initialize (linedata.nrad);
 
-    Jeff.resize (parameters.npoints());
-    Jlin.resize (parameters.npoints());
-    Jdif.resize (parameters.npoints());
+    // Flat indices over points and levels or transitions need to fit in an Index
+    check_index_range ("the level populations",            parameters.npoints(), linedata.nlev);
+    check_index_range ("the approximated lambda operator", parameters.npoints(), linedata.nrad);
 
+    const Index nind = ((Index) parameters.npoints()) * linedata.nlev;
 
-    for (Size p = 0; p < parameters.npoints(); p++)
+    // Eigen's sparse matrices use (32-bit) int indices, so the global system
+    // of rate equations is only available when its dimension fits in an int
+    if (nind <= (Index) std::numeric_limits<int>::max())
     {
-        Jeff[p].resize (linedata.nrad);
-        Jlin[p].resize (linedata.nrad);
-        Jdif[p].resize (linedata.nrad);
+        RT        .resize (nind, nind);
+        LambdaStar.resize (nind, nind);
+        LambdaTest.resize (nind, nind);
     }
 
-    nr_line.resize (parameters.npoints());
+    lambda.initialize (linedata.nrad);
 
-    for (Size p = 0; p < parameters.npoints(); p++)
-    {
-        nr_line[p].resize (linedata.nrad);
+    Jeff.resize (parameters.npoints(), linedata.nrad);
+    Jlin.resize (parameters.npoints(), linedata.nrad);
+    Jdif.resize (parameters.npoints(), linedata.nrad);
 
-        for (Size k = 0; k < linedata.nrad; k++)
-        {
-            nr_line[p][k].resize (parameters.nquads());
-        }
-    }
+    nr_line.resize (parameters.npoints(), linedata.nrad, parameters.nquads());
 
 
-    population_prev1.resize (parameters.npoints()*linedata.nlev);
-    population_prev2.resize (parameters.npoints()*linedata.nlev);
-    population_prev3.resize (parameters.npoints()*linedata.nlev);
-      population_tot.resize (parameters.npoints()*linedata.nlev);
-          population.resize (parameters.npoints()*linedata.nlev);
+    population_prev1.resize (nind);
+    population_prev2.resize (nind);
+    population_prev3.resize (nind);
+      population_tot.resize (nind);
+          population.resize (nind);
 
     const string prefix_l = prefix + std::to_string (l) + "/";
 
@@ -64,6 +67,29 @@ void LineProducingSpecies :: read (const Io& io, const Size l)
     read_populations (io, l, "");
 
 
+    if (lazy)
+    {
+        io_deferred = io.clone();
+         l_deferred = l;
+    }
+    else
+    {
+        read_previous_populations (io, l);
+    }
+}
+
+
+///  Reader for the level populations of the previous iterations
+///  Note: plain (not threaded) loops, since this can be called from within a
+///  parallel section in Model::read. There, a nested threaded_for would run on
+///  a team of one thread, which only covers its own share of the points.
+///    @param[in] io : io object
+///    @param[in] l  : nr of line producing species
+////////////////////////////////////////////////////////////////
+void LineProducingSpecies :: read_previous_populations (const Io& io, const Size l)
+{
+    const string prefix_l = prefix + std::to_string (l) + "/";
+
     Double2 pops_prev1 (parameters.npoints(), Double1 (linedata.nlev));
     Double2 pops_prev2 (parameters.npoints(), Double1 (linedata.nlev));
     Double2 pops_prev3 (parameters.npoints(), Double1 (linedata.nlev));
@@ -73,7 +99,7 @@ void LineProducingSpecies :: read (const Io& io, const Size l)
     int err_prev3 = io.read_array (prefix_l+"population_prev3", pops_prev3);
 
 
-    threaded_for (p, parameters.npoints(),
+    for (Size p = 0; p < parameters.npoints(); p++)
     {
         for (Size i = 0; i < linedata.nlev; i++)
         {
@@ -81,7 +107,26 @@ void LineProducingSpecies :: read (const Io& io, const Size l)
             if (err_prev2 == 0) {population_prev2 (index (p, i)) = pops_prev2[p][i];}
             if (err_prev3 == 0) {population_prev3 (index (p, i)) = pops_prev3[p][i];}
         }
-    })
+    }
+}
+
+
+///  Reader for the data that was deferred when reading lazily (the previous
+///  populations and the collision partners). Does nothing if there is none.
+///  Note: not thread safe, call before going parallel over the species.
+/////////////////////////////////////////////////////////////////////////////
+void LineProducingSpecies :: read_deferred_data ()
+{
+    if (io_deferred)
+    {
+        cout << "Reading deferred data of lineProducingSpecies..." << endl;
+
+        linedata.read_collision_partners (*io_deferred, l_deferred);
+
+        read_previous_populations (*io_deferred, l_deferred);
+
+        io_deferred.reset();
+    }
 }
 
 
@@ -93,7 +138,17 @@ void LineProducingSpecies :: write (const Io& io, const Size l) const
 {
     cout << "Writing lineProducingSpecies..." << endl;
 
-    linedata  .write (io, l);
+    if (io_deferred)
+    {
+        // Collision partners were not read yet, take them from the source
+        Linedata linedata_full = linedata;
+        linedata_full.read_collision_partners (*io_deferred, l_deferred);
+        linedata_full.write (io, l);
+    }
+    else
+    {
+        linedata.write (io, l);
+    }
     quadrature.write (io, l);
 
     write_populations (io, l, "");
@@ -123,6 +178,7 @@ void LineProducingSpecies :: write (const Io& io, const Size l) const
 
 
 ///  Reader for the level populations from the Io object
+///  Note: plain loops, see read_previous_populations.
 ///    @param[in] io  : io object
 ///    @param[in] l   : number of line producing species
 ///    @param[in] tag : extra info tag
@@ -137,17 +193,38 @@ void LineProducingSpecies :: read_populations (const Io &io, const Size l, const
 
     if (err == 0)
     {
-        threaded_for (p, parameters.npoints(),
+        for (Size p = 0; p < parameters.npoints(); p++)
         {
             for (Size i = 0; i < linedata.nlev; i++)
             {
                 population (index (p, i)) = pops[p][i];
             }
-        })
+        }
     }
 
-    io.read_array (prefix_l+"J_lin"+tag, Jlin);
-    io.read_array (prefix_l+"J_eff"+tag, Jeff);
+    Real2 J_buffer (parameters.npoints(), Real1 (linedata.nrad));
+
+    if (io.read_array (prefix_l+"J_lin"+tag, J_buffer) == 0)
+    {
+        for (Size p = 0; p < parameters.npoints(); p++)
+        {
+            for (Size k = 0; k < linedata.nrad; k++)
+            {
+                Jlin(p,k) = J_buffer[p][k];
+            }
+        }
+    }
+
+    if (io.read_array (prefix_l+"J_eff"+tag, J_buffer) == 0)
+    {
+        for (Size p = 0; p < parameters.npoints(); p++)
+        {
+            for (Size k = 0; k < linedata.nrad; k++)
+            {
+                Jeff(p,k) = J_buffer[p][k];
+            }
+        }
+    }
 }
 
 
@@ -177,13 +254,31 @@ void LineProducingSpecies :: write_populations (const Io& io, const Size l, cons
         io.write_array (prefix_l+"population"+tag, pops);
     }
 
+    Real2 J_buffer (parameters.npoints(), Real1 (linedata.nrad));
+
     if (Jlin.size() > 0)
     {
-        io.write_array (prefix_l+"J_lin"+tag, Jlin);
+        threaded_for (p, parameters.npoints(),
+        {
+            for (Size k = 0; k < linedata.nrad; k++)
+            {
+                J_buffer[p][k] = Jlin(p,k);
+            }
+        })
+
+        io.write_array (prefix_l+"J_lin"+tag, J_buffer);
     }
 
     if (Jeff.size() > 0)
     {
-        io.write_array (prefix_l+"J_eff"+tag, Jeff);
+        threaded_for (p, parameters.npoints(),
+        {
+            for (Size k = 0; k < linedata.nrad; k++)
+            {
+                J_buffer[p][k] = Jeff(p,k);
+            }
+        })
+
+        io.write_array (prefix_l+"J_eff"+tag, J_buffer);
     }
 }
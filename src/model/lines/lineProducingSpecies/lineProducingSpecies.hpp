@@ -12,6 +12,7 @@ using Eigen::COLAMDOrdering;
 #include "io/io.hpp"
 #include "model/parameters/parameters.hpp"
 #include "tools/types.hpp"
+#include "tools/perf_counters.hpp"
 #include "linedata/linedata.hpp"
 #include "quadrature/quadrature.hpp"
 #include "lambda/lambda.hpp"
@@ -24,11 +25,11 @@ struct LineProducingSpecies
     Quadrature quadrature;           ///< data for integral over line
     Lambda     lambda;               ///< Approximate Lambda Operator (ALO)
 
-    Real2 Jlin;                      ///< actual mean intensity in the line
-    Real2 Jeff;                      ///< effective mean intensity in the line (actual - ALO)
-    Real2 Jdif;                      ///< effective mean intensity in the line (actual - ALO)
+    Matrix<Real> Jlin;               ///< actual mean intensity in the line (p,k)
+    Matrix<Real> Jeff;               ///< effective mean intensity in the line (actual - ALO) (p,k)
+    Matrix<Real> Jdif;               ///< effective mean intensity in the line (actual - ALO) (p,k)
 
-    Size3 nr_line;                   ///< frequency number corresponing to line (p,k,z)
+    Tensor<Size> nr_line;            ///< frequency number corresponing to line (p,k,z)
 
     double relative_change_mean;     ///< mean    relative change
     double relative_change_max;      ///< maximum relative change
@@ -49,28 +50,53 @@ struct LineProducingSpecies
     SparseMatrix<Real> LambdaTest;
     SparseMatrix<Real> LambdaStar;
 
+    std::shared_ptr<const Io> io_deferred;   ///< io to read deferred data from (nullptr if none)
+    Size                       l_deferred;   ///< index of this species in io_deferred
+
     void read  (const Io& io, const Size l);
+    void read  (const Io& io, const Size l, const bool lazy);
     void write (const Io& io, const Size l) const;
 
+    void read_previous_populations (const Io& io, const Size l);
+    void read_deferred_data        ();
+
     void read_populations  (const Io& io, const Size l, const string tag);
     void write_populations (const Io& io, const Size l, const string tag) const;
 
-    inline Size index (const Size p, const Size i) const;
+    inline Index index (const Size p, const Size i) const;
 
     inline Real get_emissivity (const Size p, const Size k) const;
     inline Real get_opacity    (const Size p, const Size k) const;
 
+    inline double get_solve_cost () const;
+
     inline void check_for_convergence (
         const Real pop_prec );
 
     inline void update_using_LTE (
-        const Double2      &abundance,
+        const Matrix<Real> &abundance,
         const Vector<Real> &temperature );
 
+    inline void update_using_LVG (
+        const Matrix<Real> &abundance,
+        const Vector<Real> &temperature,
+        const Real1        &velocity_gradient );
+
+    inline void update_using_interpolation (
+        const Matrix<Real>         &abundance,
+        const LineProducingSpecies &source,
+        const Size2                &nearest,
+        const Double2              &weight    );
+
     inline void update_using_statistical_equilibrium (
-        const Double2      &abundance,
+        const Matrix<Real> &abundance,
         const Vector<Real> &temperature );
 
+    inline void update_using_statistical_equilibrium (
+        const Matrix<Real> &abundance,
+        const Vector<Real> &temperature,
+        const Size          p           );
+
     inline void update_using_Ng_acceleration ();
     inline void update_using_acceleration (const Size order);
 };
@@ -1,9 +1,11 @@
 #include <math.h>
+#include <algorithm>
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
 #include "tools/constants.hpp"
 #include "tools/types.hpp"
+#include "tools/summation.hpp"
 #include "paracabs.hpp"
 
 
@@ -12,9 +14,9 @@
 ///    @param[in] i : index of the level
 ///    @return corresponding index for p and i
 //////////////////////////////////////////////
-inline Size LineProducingSpecies :: index (const Size p, const Size i) const
+inline Index LineProducingSpecies :: index (const Size p, const Size i) const
 {
-    return i + p*linedata.nlev;
+    return i + ((Index) p)*linedata.nlev;
 }
 
 
@@ -25,7 +27,7 @@ inline Size LineProducingSpecies :: index (const Size p, const Size i) const
 //////////////////////////////////////////////////////////
 inline Real LineProducingSpecies :: get_emissivity (const Size p, const Size k) const
 {
-  const Size i = index (p, linedata.irad[k]);
+  const Index i = index (p, linedata.irad[k]);
 
   return HH_OVER_FOUR_PI * linedata.A[k] * population(i);
 }
@@ -38,14 +40,30 @@ inline Real LineProducingSpecies :: get_emissivity (const Size p, const Size k)
 ///////////////////////////////////////////////////////
 inline Real LineProducingSpecies :: get_opacity (const Size p, const Size k) const
 {
-  const Size i = index (p, linedata.irad[k]);
-  const Size j = index (p, linedata.jrad[k]);
+  const Index i = index (p, linedata.irad[k]);
+  const Index j = index (p, linedata.jrad[k]);
 
   return HH_OVER_FOUR_PI * (  population(j) * linedata.Ba[k]
                             - population(i) * linedata.Bs[k] );
 }
 
 
+///  Estimate of the (relative) cost of solving the statistical equilibrium
+///  equations, used to balance the species over the available threads
+///    @return estimated number of operations for one update
+//////////////////////////////////////////////////////////////////////////
+inline double LineProducingSpecies :: get_solve_cost () const
+{
+    const double nlev = linedata.nlev;
+
+    // Assembly scales with the number of non-zeros in the rate matrix,
+    // factorisation with the (dense) blocks of levels in each point
+    return parameters.npoints() * (  nlev * nlev * nlev
+                                   + 6.0 * linedata.nrad
+                                   + 4.0 * linedata.ncol_tot );
+}
+
+
 ///  set_LTE_level_populations
 ///    @param[in] abundance_lspec: abundance of line species
 ///    @param[in] temperature: local gas temperature
@@ -53,18 +71,18 @@ inline Real LineProducingSpecies :: get_opacity (const Size p, const Size k) con
 ///    @param[in] l: number of line producing species
 ///////////////////////////////////////////////////////////
 inline void LineProducingSpecies :: update_using_LTE (
-    const Double2      &abundance,
+    const Matrix<Real> &abundance,
     const Vector<Real> &temperature )
 {
     threaded_for (p, parameters.npoints(),
     {
-        population_tot[p] = abundance[p][linedata.num];
+        population_tot[p] = abundance(p, linedata.num);
 
         Real partition_function = 0.0;
 
         for (Size i = 0; i < linedata.nlev; i++)
         {
-            const Size ind = index (p, i);
+            const Index ind = index (p, i);
 
             population(ind) = linedata.weight[i]
                               * exp (-linedata.energy[i] / (KB*temperature[p]));
@@ -74,7 +92,7 @@ inline void LineProducingSpecies :: update_using_LTE (
 
         for (Size i = 0; i < linedata.nlev; i++)
         {
-            const Size ind = index (p, i);
+            const Index ind = index (p, i);
 
             population(ind) *= population_tot[p] / partition_function;
         }
@@ -84,50 +102,242 @@ inline void LineProducingSpecies :: update_using_LTE (
 }
 
 
-inline void LineProducingSpecies :: check_for_convergence (const Real pop_prec)
+///  update_using_interpolation: interpolates the fractional level populations of
+///  the same species in another model, and scales them with the total population
+///    @param[in] abundance: chemical abundances of species in the model
+///    @param[in] source: the same line producing species in the other model
+///    @param[in] nearest: points of the other model to interpolate from, per point
+///    @param[in] weight: corresponding (normalised) interpolation weights
+/////////////////////////////////////////////////////////////////////////////////
+inline void LineProducingSpecies :: update_using_interpolation (
+    const Matrix<Real>         &abundance,
+    const LineProducingSpecies &source,
+    const Size2                &nearest,
+    const Double2              &weight    )
 {
-    const Real weight = 1.0 / (parameters.npoints() * linedata.nlev);
+    threaded_for (p, parameters.npoints(),
+    {
+        population_tot[p] = abundance(p, linedata.num);
+
+        Real fraction_tot = 0.0;
+
+        for (Size i = 0; i < linedata.nlev; i++)
+        {
+            Real fraction = 0.0;
 
-    Real fnc = 0.0;
-    Real rcm = 0.0;
+            for (Size n = 0; n < nearest[p].size(); n++)
+            {
+                const Size q = nearest[p][n];
 
-    relative_change_max = 0.0;
+                if (source.population_tot[q] > 0.0)
+                {
+                    fraction += weight[p][n] * source.population(source.index(q,i)) / source.population_tot[q];
+                }
+            }
 
-//    for (long p = 0; p < ncells; p++)
-#   pragma omp parallel for reduction (+: fnc, rcm)
-    for (Size p = 0; p < parameters.npoints(); p++)
-    {
-        const double min_pop = 1.0E-10 * population_tot[p];
+            population(index(p,i)) = fraction;
+            fraction_tot          += fraction;
+        }
 
         for (Size i = 0; i < linedata.nlev; i++)
         {
-            const Size ind = index (p, i);
+            if (fraction_tot > 0.0)
+            {
+                population(index(p,i)) *= population_tot[p] / fraction_tot;
+            }
+        }
+    })
+
+    populations.push_back (population);
+}
+
+
+///  update_using_LVG: computes level populations in the large velocity gradient
+///  (Sobolev) approximation, using local escape probabilities rather than the
+///  actual radiation field. No rays are traced, the points are independent.
+///    @param[in] abundance: chemical abundances of species in the model
+///    @param[in] temperature: gas temperature in the model
+///    @param[in] velocity_gradient: local (line of sight) gradient of v/c [1/m]
+////////////////////////////////////////////////////////////////////////////////
+inline void LineProducingSpecies :: update_using_LVG (
+    const Matrix<Real> &abundance,
+    const Vector<Real> &temperature,
+    const Real1        &velocity_gradient )
+{
+    const Size nlev             = linedata.nlev;
+    const Size max_niterations  = 100;
+    const Real max_rel_change   = 1.0E-6;
+
+    threaded_for (p, parameters.npoints(),
+    {
+        Real1 Ce_loc;
+        Real1 Cd_loc;
+
+        for (Size it = 0; it < max_niterations; it++)
+        {
+            MatrixXr R = MatrixXr::Zero (nlev, nlev);
+            VectorXr y = VectorXr::Zero (nlev);
 
-            if (population(ind) > min_pop)
+            // Radiative transitions, with escape probabilities
+            for (Size k = 0; k < linedata.nrad; k++)
             {
-                Real relative_change = 2.0;
+                const Size i = linedata.irad[k];
+                const Size j = linedata.jrad[k];
+
+                const Real freq = linedata.frequency[k];
+                const Real tau  = get_opacity(p,k) / (freq * velocity_gradient[p]);
+
+                // Masing (tau < 0) and thin lines are treated as optically thin
+                const Real beta = (tau < 1.0E-5) ? 1.0 : -expm1 (-tau) / tau;
 
-                relative_change *= fabs (population (ind) - population_prev1 (ind));
-                relative_change /=      (population (ind) + population_prev1 (ind));
+                // Background (CMB) radiation field
+                const Real J_bg = TWO_HH_OVER_CC_SQUARED * (freq*freq*freq) / expm1 (HH_OVER_KB*freq/T_CMB);
+
+                const Real v_IJ = beta * (linedata.A[k] + linedata.Bs[k] * J_bg);
+                const Real v_JI = beta *                  linedata.Ba[k] * J_bg;
+
+                // Note: we define our transition matrix as the transpose of R in the paper.
+                if (j != nlev-1)
+                {
+                    R(j,i) += v_IJ;
+                    R(j,j) -= v_JI;
+                }
 
-                if (relative_change > pop_prec)
+                if (i != nlev-1)
                 {
-                    fnc += weight;
+                    R(i,j) += v_JI;
+                    R(i,i) -= v_IJ;
                 }
+            }
 
-                rcm += (weight * relative_change);
+            // Collisional transitions
+            for (const CollisionPartner &colpar : linedata.colpar)
+            {
+                Real abn = abundance(p, colpar.num_col_partner);
+                Real tmp = temperature[p];
+
+                colpar.adjust_abundance_for_ortho_or_para (tmp, abn);
+                colpar.interpolate_collision_coefficients (tmp, Ce_loc, Cd_loc);
 
-                // NOT THREAD SAFE !!!
-                //if (relative_change > relative_change_max)
-                //{
-                //  relative_change_max = relative_change;
-                //}
+                for (Size k = 0; k < colpar.ncol; k++)
+                {
+                    const Real v_IJ = Cd_loc[k] * abn;
+                    const Real v_JI = Ce_loc[k] * abn;
+
+                    const Size i = colpar.icol[k];
+                    const Size j = colpar.jcol[k];
+
+                    // Note: we define our transition matrix as the transpose of R in the paper.
+                    if (j != nlev-1)
+                    {
+                        R(j,i) += v_IJ;
+                        R(j,j) -= v_JI;
+                    }
+
+                    if (i != nlev-1)
+                    {
+                        R(i,j) += v_JI;
+                        R(i,i) -= v_IJ;
+                    }
+                }
+            }
+
+            // Conservation of the total population
+            for (Size i = 0; i < nlev; i++)
+            {
+                R(nlev-1, i) = 1.0;
+            }
+
+            y[nlev-1] = population_tot[p];
+
+            const VectorXr pop = R.colPivHouseholderQr().solve (y);
+
+            // Average with the previous iterate to damp oscillations in tau
+            Real rel_change = 0.0;
+
+            for (Size i = 0; i < nlev; i++)
+            {
+                const Index ind = index (p, i);
+
+                if (pop[i] > 1.0E-10 * population_tot[p])
+                {
+                    rel_change = std::max (rel_change, fabs (pop[i] - population(ind)) / pop[i]);
+                }
+
+                population(ind) = 0.5 * (population(ind) + pop[i]);
             }
+
+            if (rel_change < max_rel_change) {break;}
         }
-    }
+    })
 
-    fraction_not_converged = fnc;
-    relative_change_mean   = rcm;
+    populations.push_back (population);
+}
+
+
+///  Compute the convergence statistics of the level populations w.r.t. the
+///  previous iteration. The points are summed in fixed chunks, which are then
+///  reduced in a fixed (pairwise) order, such that the statistics, and hence
+///  the number of iterations, are the same for any number of threads.
+///    @param[in] pop_prec : required relative precision of the populations
+//////////////////////////////////////////////////////////////////////////////
+inline void LineProducingSpecies :: check_for_convergence (const Real pop_prec)
+{
+    const Real weight = 1.0 / ((Real) parameters.npoints() * linedata.nlev);
+
+    const Size chunk   = 256;
+    const Size nchunks = (parameters.npoints() + chunk - 1) / chunk;
+
+    Real1 fnc (nchunks);
+    Real1 rcm (nchunks);
+    Real1 rcx (nchunks);
+
+    threaded_for (c, nchunks,
+    {
+        const Size p_end = std::min ((Size) ((c+1)*chunk), parameters.npoints());
+
+        Real fnc_c = 0.0;
+        Real rcm_c = 0.0;
+        Real rcx_c = 0.0;
+
+        for (Size p = c*chunk; p < p_end; p++)
+        {
+            const double min_pop = 1.0E-10 * population_tot[p];
+
+            for (Size i = 0; i < linedata.nlev; i++)
+            {
+                const Index ind = index (p, i);
+
+                if (population(ind) > min_pop)
+                {
+                    Real relative_change = 2.0;
+
+                    relative_change *= fabs (population (ind) - population_prev1 (ind));
+                    relative_change /=      (population (ind) + population_prev1 (ind));
+
+                    if (relative_change > pop_prec)
+                    {
+                        fnc_c += weight;
+                    }
+
+                    rcm_c += (weight * relative_change);
+
+                    if (relative_change > rcx_c)
+                    {
+                        rcx_c = relative_change;
+                    }
+                }
+            }
+        }
+
+        fnc[c] = fnc_c;
+        rcm[c] = rcm_c;
+        rcx[c] = rcx_c;
+    })
+
+    fraction_not_converged = pairwise_sum (fnc);
+    relative_change_mean   = pairwise_sum (rcm);
+    relative_change_max    = *std::max_element (rcx.begin(), rcx.end());
 }
 
 
@@ -137,7 +347,7 @@ inline void LineProducingSpecies :: check_for_convergence (const Real pop_prec)
 ///////////////////////////////////////////////////////////////////////////
 void LineProducingSpecies :: update_using_Ng_acceleration ()
 {
-    VectorXr Wt (parameters.npoints()*linedata.nlev);
+    VectorXr Wt (((Index) parameters.npoints())*linedata.nlev);
 
     VectorXr Q1 = population - 2.0*population_prev1 + population_prev2;
     VectorXr Q2 = population -     population_prev1 - population_prev2 + population_prev3;
@@ -228,12 +438,22 @@ void LineProducingSpecies :: update_using_acceleration (const Size order)
 ///    @param[in] temperature: gas temperature in the model
 /////////////////////////////////////////////////////////////////////////////////
 inline void LineProducingSpecies :: update_using_statistical_equilibrium (
-    const Double2      &abundance,
+    const Matrix<Real> &abundance,
     const Vector<Real> &temperature )
 {
-    const Size non_zeros = parameters.npoints() * (      linedata.nlev
-                                                   + 6 * linedata.nrad
-                                                   + 4 * linedata.ncol_tot );
+    PERF_SCOPE (PERF_RATE_EQUATIONS);
+
+    const Index nind = ((Index) parameters.npoints()) * linedata.nlev;
+
+    // Eigen's sparse matrices use (32-bit) int indices
+    if (nind > (Index) std::numeric_limits<int>::max())
+    {
+        throw std::runtime_error ("Too many levels (" + to_string (nind) + ") for a single system of rate equations.");
+    }
+
+    const Index non_zeros = ((Index) parameters.npoints()) * (      linedata.nlev
+                                                              + 6 * linedata.nrad
+                                                              + 4 * linedata.ncol_tot );
 
     population_prev3 = population_prev2;
     population_prev2 = population_prev1;
@@ -244,125 +464,155 @@ inline void LineProducingSpecies :: update_using_statistical_equilibrium (
 
 //    SparseMatrix<double> RT (ncells*linedata.nlev, ncells*linedata.nlev);
 
-    VectorXr y = VectorXr::Zero (parameters.npoints()*linedata.nlev);
+    VectorXr y = VectorXr::Zero (nind);
+
+    // The rate matrix is assembled in chunks of points, each with its own list
+    // of triplets (push_back is not thread safe), which are concatenated in the
+    // order of the points afterwards, such that the result does not depend on
+    // the number of threads. The chunks are spawned as tasks, so they are shared
+    // with the threads that are not busy with other species (see Lines).
+    const Size chunk   = 256;
+    const Size nchunks = (parameters.npoints() + chunk - 1) / chunk;
 
-    vector<Triplet<Real, Size>> triplets;
+    vector<vector<Triplet<Real, Index>>> triplets_chunk (nchunks);
 //    vector<Triplet<Real, Size>> triplets_LT;
 //    vector<Triplet<Real, Size>> triplets_LS;
 
-    triplets   .reserve (non_zeros);
-//    triplets_LT.reserve (non_zeros);
-//    triplets_LS.reserve (non_zeros);
-
-    for (Size p = 0; p < parameters.npoints(); p++) // !!! no OMP because push_back is not thread safe !!!
+#   pragma omp taskloop default (shared)
+    for (Size c = 0; c < nchunks; c++)
     {
-        // Radiative transitions
-
-        for (Size k = 0; k < linedata.nrad; k++)
-        {
-            const Real v_IJ = linedata.A[k] + linedata.Bs[k] * Jeff[p][k];
-            const Real v_JI =                 linedata.Ba[k] * Jeff[p][k];
+        vector<Triplet<Real, Index>>& triplets = triplets_chunk[c];
 
-            // const Real t_IJ = linedata.Bs[k] * Jdif[p][k];
-            // const Real t_JI = linedata.Ba[k] * Jdif[p][k];
+        const Size p_bgn = c*chunk;
+        const Size p_end = std::min ((Size) ((c+1)*chunk), parameters.npoints());
 
-            // Note: we define our transition matrix as the transpose of R in the paper.
-            const Size I = index (p, linedata.irad[k]);
-            const Size J = index (p, linedata.jrad[k]);
+        triplets   .reserve (non_zeros / parameters.npoints() * (p_end - p_bgn));
+//        triplets_LT.reserve (non_zeros);
+//        triplets_LS.reserve (non_zeros);
 
-            if (linedata.jrad[k] != linedata.nlev-1)
-            {
-                triplets   .push_back (Triplet<Real, Size> (J, I, +v_IJ));
-                triplets   .push_back (Triplet<Real, Size> (J, J, -v_JI));
+        Real1 Ce_loc;
+        Real1 Cd_loc;
 
-                // triplets_LS.push_back (Triplet<Real, Size> (J, I, +t_IJ));
-                // triplets_LS.push_back (Triplet<Real, Size> (J, J, -t_JI));
-            }
+        for (Size p = p_bgn; p < p_end; p++)
+        {
+            // Radiative transitions
 
-            if (linedata.irad[k] != linedata.nlev-1)
+            for (Size k = 0; k < linedata.nrad; k++)
             {
-                triplets   .push_back (Triplet<Real, Size> (I, J, +v_JI));
-                triplets   .push_back (Triplet<Real, Size> (I, I, -v_IJ));
-
-                // triplets_LS.push_back (Triplet<Real, Size> (I, J, +t_JI));
-                // triplets_LS.push_back (Triplet<Real, Size> (I, I, -t_IJ));
-            }
-        }
-
-        // Approximated Lambda operator
+                const Real v_IJ = linedata.A[k] + linedata.Bs[k] * Jeff(p,k);
+                const Real v_JI =                 linedata.Ba[k] * Jeff(p,k);
 
-        for (Size k = 0; k < linedata.nrad; k++)
-        {
-            for (Size m = 0; m < lambda.get_size(p,k); m++)
-            {
-                const Size   nr =  lambda.get_nr(p, k, m);
-                const Real v_IJ = -lambda.get_Ls(p, k, m) * get_opacity(p, k);
+                // const Real t_IJ = linedata.Bs[k] * Jdif[p][k];
+                // const Real t_JI = linedata.Ba[k] * Jdif[p][k];
 
                 // Note: we define our transition matrix as the transpose of R in the paper.
-                const Size I = index (nr, linedata.irad[k]);
-                const Size J = index (p,  linedata.jrad[k]);
+                const Index I = index (p, linedata.irad[k]);
+                const Index J = index (p, linedata.jrad[k]);
 
                 if (linedata.jrad[k] != linedata.nlev-1)
                 {
-                    triplets   .push_back (Triplet<Real, Size> (J, I, +v_IJ));
-                    // triplets_LT.push_back (Triplet<Real, Size> (J, I, +v_IJ));
+                    triplets   .push_back (Triplet<Real, Index> (J, I, +v_IJ));
+                    triplets   .push_back (Triplet<Real, Index> (J, J, -v_JI));
+
+                    // triplets_LS.push_back (Triplet<Real, Size> (J, I, +t_IJ));
+                    // triplets_LS.push_back (Triplet<Real, Size> (J, J, -t_JI));
                 }
 
                 if (linedata.irad[k] != linedata.nlev-1)
                 {
-                    triplets   .push_back (Triplet<Real, Size> (I, I, -v_IJ));
-                    // triplets_LT.push_back (Triplet<Real, Size> (I, I, -v_IJ));
+                    triplets   .push_back (Triplet<Real, Index> (I, J, +v_JI));
+                    triplets   .push_back (Triplet<Real, Index> (I, I, -v_IJ));
+
+                    // triplets_LS.push_back (Triplet<Real, Size> (I, J, +t_JI));
+                    // triplets_LS.push_back (Triplet<Real, Size> (I, I, -t_IJ));
                 }
             }
-        }
 
+            // Approximated Lambda operator
 
+            for (Size k = 0; k < linedata.nrad; k++)
+            {
+                for (Size m = 0; m < lambda.get_size(p,k); m++)
+                {
+                    const Size   nr =  lambda.get_nr(p, k, m);
+                    const Real v_IJ = -lambda.get_Ls(p, k, m) * get_opacity(p, k);
+
+                    // Note: we define our transition matrix as the transpose of R in the paper.
+                    const Index I = index (nr, linedata.irad[k]);
+                    const Index J = index (p,  linedata.jrad[k]);
+
+                    if (linedata.jrad[k] != linedata.nlev-1)
+                    {
+                        triplets   .push_back (Triplet<Real, Index> (J, I, +v_IJ));
+                        // triplets_LT.push_back (Triplet<Real, Size> (J, I, +v_IJ));
+                    }
+
+                    if (linedata.irad[k] != linedata.nlev-1)
+                    {
+                        triplets   .push_back (Triplet<Real, Index> (I, I, -v_IJ));
+                        // triplets_LT.push_back (Triplet<Real, Size> (I, I, -v_IJ));
+                    }
+                }
+            }
 
-        // Collisional transitions
 
-        for (CollisionPartner &colpar : linedata.colpar)
-        {
-            Real abn = abundance[p][colpar.num_col_partner];
-            Real tmp = temperature[p];
 
-            colpar.adjust_abundance_for_ortho_or_para (tmp, abn);
-            colpar.interpolate_collision_coefficients (tmp);
+            // Collisional transitions
 
-            for (Size k = 0; k < colpar.ncol; k++)
+            for (const CollisionPartner &colpar : linedata.colpar)
             {
-                const Real v_IJ = colpar.Cd_intpld[k] * abn;
-                const Real v_JI = colpar.Ce_intpld[k] * abn;
+                Real abn = abundance(p, colpar.num_col_partner);
+                Real tmp = temperature[p];
 
-                // Note: we define our transition matrix as the transpose of R in the paper.
-                const Size I = index (p, colpar.icol[k]);
-                const Size J = index (p, colpar.jcol[k]);
+                colpar.adjust_abundance_for_ortho_or_para (tmp, abn);
+                colpar.interpolate_collision_coefficients (tmp, Ce_loc, Cd_loc);
 
-                if (colpar.jcol[k] != linedata.nlev-1)
+                for (Size k = 0; k < colpar.ncol; k++)
                 {
-                    triplets.push_back (Triplet<Real, Size> (J, I, +v_IJ));
-                    triplets.push_back (Triplet<Real, Size> (J, J, -v_JI));
+                    const Real v_IJ = Cd_loc[k] * abn;
+                    const Real v_JI = Ce_loc[k] * abn;
+
+                    // Note: we define our transition matrix as the transpose of R in the paper.
+                    const Index I = index (p, colpar.icol[k]);
+                    const Index J = index (p, colpar.jcol[k]);
+
+                    if (colpar.jcol[k] != linedata.nlev-1)
+                    {
+                        triplets.push_back (Triplet<Real, Index> (J, I, +v_IJ));
+                        triplets.push_back (Triplet<Real, Index> (J, J, -v_JI));
+                    }
+
+                    if (colpar.icol[k] != linedata.nlev-1)
+                    {
+                        triplets.push_back (Triplet<Real, Index> (I, J, +v_JI));
+                        triplets.push_back (Triplet<Real, Index> (I, I, -v_IJ));
+                    }
                 }
+            }
 
-                if (colpar.icol[k] != linedata.nlev-1)
-                {
-                    triplets.push_back (Triplet<Real, Size> (I, J, +v_JI));
-                    triplets.push_back (Triplet<Real, Size> (I, I, -v_IJ));
-                }
+
+            for (Size i = 0; i < linedata.nlev; i++)
+            {
+                const Index I = index (p, linedata.nlev-1);
+                const Index J = index (p, i);
+
+                triplets.push_back (Triplet<Real, Index> (I, J, 1.0));
             }
-        }
 
+            y[index (p, linedata.nlev-1)] = population_tot[p];
 
-        for (Size i = 0; i < linedata.nlev; i++)
-        {
-            const Size I = index (p, linedata.nlev-1);
-            const Size J = index (p, i);
+        } // for all cells in chunk
+    } // for all chunks
 
-            triplets.push_back (Triplet<Real, Size> (I, J, 1.0));
-        }
 
-        y[index (p, linedata.nlev-1)] = population_tot[p];
+    vector<Triplet<Real, Index>> triplets;
+
+    triplets.reserve (non_zeros);
 
-    } // for all cells
+    for (const vector<Triplet<Real, Index>>& triplets_c : triplets_chunk)
+    {
+        triplets.insert (triplets.end(), triplets_c.begin(), triplets_c.end());
+    }
 
 
     RT        .setFromTriplets (triplets   .begin(), triplets   .end());
@@ -404,18 +654,24 @@ inline void LineProducingSpecies :: update_using_statistical_equilibrium (
     //Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
 
 
+    // Species can be solved concurrently (see Lines), so keep their output in one piece
+#   pragma omp critical (lspec_output)
     cout << "Analyzing system of rate equations..."      << endl;
 
     solver.analyzePattern (RT);
 
+#   pragma omp critical (lspec_output)
     cout << "Factorizing system of rate equations..."    << endl;
 
     solver.factorize (RT);
 
     if (solver.info() != Eigen::Success)
     {
-        cout << "Factorization failed with error message:" << endl;
-        cout << solver.lastErrorMessage()                  << endl;
+#       pragma omp critical (lspec_output)
+        {
+            cout << "Factorization failed with error message:" << endl;
+            cout << solver.lastErrorMessage()                  << endl;
+        }
 
         // cout << endl << RT << endl;
 
@@ -432,17 +688,22 @@ inline void LineProducingSpecies :: update_using_statistical_equilibrium (
     //  //assert(false);
     //}
 
+#   pragma omp critical (lspec_output)
     cout << "Solving rate equations for the level populations..." << endl;
 
     population = solver.solve (y);
 
     if (solver.info() != Eigen::Success)
     {
-        cout << "Solving failed with error:" << endl;
-        cout << solver.lastErrorMessage()    << endl;
+#       pragma omp critical (lspec_output)
+        {
+            cout << "Solving failed with error:" << endl;
+            cout << solver.lastErrorMessage()    << endl;
+        }
         assert (false);
     }
 
+#   pragma omp critical (lspec_output)
     cout << "Succesfully solved for the level populations!"       << endl;
 
     //OMP_PARALLEL_FOR (p, ncells)
@@ -461,3 +722,114 @@ inline void LineProducingSpecies :: update_using_statistical_equilibrium (
     //  }
     //}
 }
+
+
+///  update_using_statistical_equilibrium: computes the level populations in a
+///  single point by solving its statistical equilibrium equations, treating only
+///  the local (diagonal) part of the ALO implicitly (for Gauss-Seidel sweeps)
+///  Only writes data of point p, so different points can be solved concurrently.
+///    @param[in] abundance: chemical abundances of species in the model
+///    @param[in] temperature: gas temperature in the model
+///    @param[in] p: index of the point
+/////////////////////////////////////////////////////////////////////////////////
+inline void LineProducingSpecies :: update_using_statistical_equilibrium (
+    const Matrix<Real> &abundance,
+    const Vector<Real> &temperature,
+    const Size          p           )
+{
+    const Size nlev = linedata.nlev;
+
+    MatrixXr R = MatrixXr::Zero (nlev, nlev);
+    VectorXr y = VectorXr::Zero (nlev);
+
+    // Radiative transitions
+
+    for (Size k = 0; k < linedata.nrad; k++)
+    {
+        const Size i = linedata.irad[k];
+        const Size j = linedata.jrad[k];
+
+        // Local part of the approximated Lambda operator
+        Real L_loc = 0.0;
+
+        for (Size m = 0; m < lambda.get_size(p,k); m++)
+        {
+            if (lambda.get_nr(p,k,m) == p)
+            {
+                L_loc += lambda.get_Ls(p,k,m);
+            }
+        }
+
+        Jdif(p,k) = HH_OVER_FOUR_PI * L_loc * population(index(p,i));
+        Jeff(p,k) = Jlin(p,k) - Jdif(p,k);
+
+        const Real v_IJ = linedata.A[k] + linedata.Bs[k] * Jeff(p,k) - L_loc * get_opacity(p,k);
+        const Real v_JI =                 linedata.Ba[k] * Jeff(p,k);
+
+        // Note: we define our transition matrix as the transpose of R in the paper.
+        if (j != nlev-1)
+        {
+            R(j,i) += v_IJ;
+            R(j,j) -= v_JI;
+        }
+
+        if (i != nlev-1)
+        {
+            R(i,j) += v_JI;
+            R(i,i) -= v_IJ;
+        }
+    }
+
+    // Collisional transitions (interpolated in local vectors, such that
+    // different points can be solved concurrently)
+
+    Real1 Ce_loc;
+    Real1 Cd_loc;
+
+    for (const CollisionPartner &colpar : linedata.colpar)
+    {
+        Real abn = abundance(p, colpar.num_col_partner);
+        Real tmp = temperature[p];
+
+        colpar.adjust_abundance_for_ortho_or_para (tmp, abn);
+        colpar.interpolate_collision_coefficients (tmp, Ce_loc, Cd_loc);
+
+        for (Size k = 0; k < colpar.ncol; k++)
+        {
+            const Real v_IJ = Cd_loc[k] * abn;
+            const Real v_JI = Ce_loc[k] * abn;
+
+            const Size i = colpar.icol[k];
+            const Size j = colpar.jcol[k];
+
+            // Note: we define our transition matrix as the transpose of R in the paper.
+            if (j != nlev-1)
+            {
+                R(j,i) += v_IJ;
+                R(j,j) -= v_JI;
+            }
+
+            if (i != nlev-1)
+            {
+                R(i,j) += v_JI;
+                R(i,i) -= v_IJ;
+            }
+        }
+    }
+
+    // Conservation of the total population
+
+    for (Size i = 0; i < nlev; i++)
+    {
+        R(nlev-1, i) = 1.0;
+    }
+
+    y[nlev-1] = population_tot[p];
+
+    const VectorXr pop = R.colPivHouseholderQr().solve (y);
+
+    for (Size i = 0; i < nlev; i++)
+    {
+        population(index(p,i)) = pop[i];
+    }
+}
@@ -34,6 +34,11 @@ struct CollisionPartner
 
     inline void interpolate_collision_coefficients (
           const Real temperature_gas );
+
+    inline void interpolate_collision_coefficients (
+          const Real  temperature_gas,
+                Real1 &Ce_loc,
+                Real1 &Cd_loc ) const;
 };
 
 
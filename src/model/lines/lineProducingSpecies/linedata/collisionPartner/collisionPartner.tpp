@@ -5,27 +5,45 @@
 ///    @param[in] temperature_gas: local gas temperature
 ////////////////////////////////////////////////////////
 inline void CollisionPartner :: interpolate_collision_coefficients (const Real temperature_gas)
+{
+    interpolate_collision_coefficients (temperature_gas, Ce_intpld, Cd_intpld);
+}
+
+
+///  interpolate_collision_coefficients: thread safe version, writing the result
+///  in the given vectors rather than in Ce_intpld and Cd_intpld
+///    @param[in]  temperature_gas: local gas temperature
+///    @param[out] Ce_loc: interpolated collisional excitation rates
+///    @param[out] Cd_loc: interpolated collisional de-excitation rates
+////////////////////////////////////////////////////////////////////////////////
+inline void CollisionPartner :: interpolate_collision_coefficients (
+    const Real  temperature_gas,
+          Real1 &Ce_loc,
+          Real1 &Cd_loc ) const
 {
     const Size t = search (tmp, temperature_gas);
 
     if (t == 0)
     {
-        Ce_intpld = Ce[0];
-        Cd_intpld = Cd[0];
+        Ce_loc = Ce[0];
+        Cd_loc = Cd[0];
     }
     else if (t == ntmp-1)
     {
-        Ce_intpld = Ce[ntmp-1];
-        Cd_intpld = Cd[ntmp-1];
+        Ce_loc = Ce[ntmp-1];
+        Cd_loc = Cd[ntmp-1];
     }
     else
     {
         const Real step = (temperature_gas - tmp[t-1]) / (tmp[t] - tmp[t-1]);
 
+        Ce_loc.resize (ncol);
+        Cd_loc.resize (ncol);
+
         for (Size k = 0; k < ncol; k++)
         {
-            Ce_intpld[k] = Ce[t-1][k] + (Ce[t][k] - Ce[t-1][k]) * step;
-            Cd_intpld[k] = Cd[t-1][k] + (Cd[t][k] - Cd[t-1][k]) * step;
+            Ce_loc[k] = Ce[t-1][k] + (Ce[t][k] - Ce[t-1][k]) * step;
+            Cd_loc[k] = Cd[t-1][k] + (Cd[t][k] - Cd[t-1][k]) * step;
         }
     }
 }
@@ -11,6 +11,17 @@ const string prefix = "lines/lineProducingSpecies_";
 ///    @param[in] l: nr of line producing species
 /////////////////////////////////////////////////
 void Linedata :: read (const Io& io, const Size l)
+{
+    read (io, l, false);
+}
+
+
+///  read: read in line data, optionally without the collision partners
+///    @param[in] io: io object
+///    @param[in] l: nr of line producing species
+///    @param[in] lazy: true to defer reading the collision partners
+/////////////////////////////////////////////////////////////////////////
+void Linedata :: read (const Io& io, const Size l, const bool lazy)
 {
     cout << "Reading linedata..." << endl;
 
@@ -59,6 +70,23 @@ void Linedata :: read (const Io& io, const Size l)
     // Get ncolpar
     io.read_length (prefix_l+"collisionPartner_", ncolpar);
 
+    if (lazy)
+    {
+        ncol_tot = 0;
+    }
+    else
+    {
+        read_collision_partners (io, l);
+    }
+}
+
+
+///  read_collision_partners: read in the collision partner data
+///    @param[in] io: io object
+///    @param[in] l: nr of line producing species
+//////////////////////////////////////////////////////////////
+void Linedata :: read_collision_partners (const Io& io, const Size l)
+{
     colpar.resize (ncolpar);
 
     for (Size c = 0; c < ncolpar; c++)
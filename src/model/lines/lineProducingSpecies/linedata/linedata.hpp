@@ -38,5 +38,8 @@ struct Linedata
     Size ncol_tot;
 
     void read  (const Io& io, const Size l);
+    void read  (const Io& io, const Size l, const bool lazy);
     void write (const Io& io, const Size l) const;
+
+    void read_collision_partners (const Io& io, const Size l);
 };
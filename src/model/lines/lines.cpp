@@ -1,5 +1,7 @@
 #include "lines.hpp"
 #include "tools/heapsort.hpp"
+#include <algorithm>
+#include <exception>
 
 
 const string prefix = "lines/";
@@ -10,6 +12,16 @@ const string prefix = "lines/";
 ///    @param[in] parameters : model parameters object
 //////////////////////////////////////////////////////
 void Lines :: read (const Io& io)
+{
+    read (io, false);
+}
+
+
+///  Reader for the Lines data
+///    @param[in] io   : io object to read with
+///    @param[in] lazy : true to defer reading the optional data
+/////////////////////////////////////////////////////////////////
+void Lines :: read (const Io& io, const bool lazy)
 {
     cout << "Reading lines..." << endl;
 
@@ -21,7 +33,7 @@ void Lines :: read (const Io& io)
 
     for (Size l = 0; l < parameters.nlspecs(); l++)
     {
-        lineProducingSpecies[l].read (io, l);
+        lineProducingSpecies[l].read (io, l, lazy);
     }
 
     /// Set nrad_cum, a helper variable for determining indices
@@ -43,6 +55,8 @@ void Lines :: read (const Io& io)
 
     parameters.set_nlines (nlines);
 
+    check_index_range ("the line data", parameters.npoints(), parameters.nlines());
+
     /// Set and sort lines and their indices
     line      .resize (parameters.nlines());
     // line_index.resize (parameters.nlines());
@@ -86,7 +100,18 @@ void Lines :: write (const Io& io) const
 }
 
 
-void Lines :: iteration_using_LTE (const Double2 &abundance, const Vector<Real> &temperature)
+///  Read the data that was deferred by a lazy read, for all species
+////////////////////////////////////////////////////////////////////
+void Lines :: read_deferred_data ()
+{
+    for (LineProducingSpecies &lspec : lineProducingSpecies)
+    {
+        lspec.read_deferred_data ();
+    }
+}
+
+
+void Lines :: iteration_using_LTE (const Matrix<Real> &abundance, const Vector<Real> &temperature)
 {
     for (LineProducingSpecies &lspec : lineProducingSpecies)
     {
@@ -99,12 +124,106 @@ void Lines :: iteration_using_LTE (const Double2 &abundance, const Vector<Real>
 }
 
 
+///  Iteration using the large velocity gradient (Sobolev) approximation
+///  The velocity gradient is bounded from below by the local line width over
+///  the cell size, such that static regions are treated as uniform cells.
+///    @param[in] abundance         : chemical abundances of species in the model
+///    @param[in] thermodynamics    : reference to thermodynamics module
+///    @param[in] velocity_gradient : local (line of sight) gradient of v/c [1/m]
+///    @param[in] cell_size         : local distance between points [m]
+////////////////////////////////////////////////////////////////////////////////
+void Lines :: iteration_using_LVG (
+    const Matrix<Real>   &abundance,
+    const Thermodynamics &thermodynamics,
+    const Real1          &velocity_gradient,
+    const Real1          &cell_size         )
+{
+    read_deferred_data ();
+
+    for (LineProducingSpecies &lspec : lineProducingSpecies)
+    {
+        Real1 gradient (parameters.npoints());
+
+        for (Size p = 0; p < parameters.npoints(); p++)
+        {
+            const Real gradient_min = thermodynamics.profile_width (lspec.linedata.inverse_mass, p) / cell_size[p];
+
+            gradient[p] = std::max (velocity_gradient[p], gradient_min);
+        }
+
+        lspec.update_using_LVG (abundance, thermodynamics.temperature.gas, gradient);
+    }
+
+    set_emissivity_and_opacity ();
+}
+
+
+///  Getter for the order in which the line producing species are updated
+///  Species are sorted by decreasing estimated cost, such that, when they
+///  are solved concurrently, the most expensive ones are started first.
+///    @return indices of the line producing species, most expensive first
+////////////////////////////////////////////////////////////////////////////
+Size1 Lines :: get_species_schedule () const
+{
+    Double1 cost     (parameters.nlspecs());
+    Size1   schedule (parameters.nlspecs());
+
+    for (Size l = 0; l < parameters.nlspecs(); l++)
+    {
+        cost    [l] = lineProducingSpecies[l].get_solve_cost ();
+        schedule[l] = l;
+    }
+
+    heapsort (cost, schedule);
+
+    std::reverse (schedule.begin(), schedule.end());
+
+    return schedule;
+}
+
+
+///  Store the exception that is currently being handled, unless one was stored
+///  already, such that it can be rethrown outside of a parallel region
+///    @param[in,out] error : first exception thrown in the parallel region
+//////////////////////////////////////////////////////////////////////////////
+inline void store_exception (std::exception_ptr& error)
+{
+#   pragma omp critical (lines_exception)
+    if (!error) {error = std::current_exception();}
+}
+
+
 void Lines :: iteration_using_Ng_acceleration (const Real pop_prec)
 {
+    read_deferred_data ();
+
+    const Size1 schedule = get_species_schedule ();
+
+    // Exceptions can not escape a task, so the first one is rethrown afterwards
+    std::exception_ptr error = nullptr;
+
+    // Extrapolate the populations of the different species concurrently
+#   pragma omp parallel default (shared)
+#   pragma omp single
+    for (Size s = 0; s < schedule.size(); s++)
+    {
+#       pragma omp task firstprivate (s)
+        try
+        {
+            lineProducingSpecies[schedule[s]].update_using_Ng_acceleration ();
+        }
+        catch (...)
+        {
+            store_exception (error);
+        }
+    }
+
+    if (error) {std::rethrow_exception (error);}
+
+    // Convergence checks are themselves parallel over the points
     for (LineProducingSpecies &lspec : lineProducingSpecies)
     {
-        lspec.update_using_Ng_acceleration ();
-        lspec.check_for_convergence        (pop_prec);
+        lspec.check_for_convergence (pop_prec);
     }
 
     set_emissivity_and_opacity ();
@@ -114,14 +233,41 @@ void Lines :: iteration_using_Ng_acceleration (const Real pop_prec)
 
 
 void Lines :: iteration_using_statistical_equilibrium (
-    const Double2      &abundance,
+    const Matrix<Real> &abundance,
     const Vector<Real> &temperature,
     const Real          pop_prec )
 {
+    read_deferred_data ();
+
+    const Size1 schedule = get_species_schedule ();
+
+    // Exceptions can not escape a task, so the first one is rethrown afterwards
+    std::exception_ptr error = nullptr;
+
+    // Solve the statistical equilibrium of the different species concurrently,
+    // starting with the most expensive ones. The assembly of each rate matrix
+    // is split further into tasks over the points, the sparse solve is serial.
+#   pragma omp parallel default (shared)
+#   pragma omp single
+    for (Size s = 0; s < schedule.size(); s++)
+    {
+#       pragma omp task firstprivate (s)
+        try
+        {
+            lineProducingSpecies[schedule[s]].update_using_statistical_equilibrium (abundance, temperature);
+        }
+        catch (...)
+        {
+            store_exception (error);
+        }
+    }
+
+    if (error) {std::rethrow_exception (error);}
+
+    // Convergence checks are themselves parallel over the points
     for (LineProducingSpecies &lspec : lineProducingSpecies)
     {
-        lspec.update_using_statistical_equilibrium (abundance, temperature);
-        lspec.check_for_convergence                (pop_prec);
+        lspec.check_for_convergence (pop_prec);
     }
 
     set_emissivity_and_opacity ();
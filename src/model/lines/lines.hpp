@@ -29,25 +29,37 @@ struct Lines
     Matrix<Real> inverse_width;   ///< inverse line width (p, lid)
 
     void read  (const Io& io);
+    void read  (const Io& io, const bool lazy);
     void write (const Io& io) const;
 
+    void read_deferred_data ();
+
+    Size1 get_species_schedule () const;
+
     void iteration_using_LTE (
-        const Double2      &abundance,
+        const Matrix<Real> &abundance,
         const Vector<Real> &temperature);
 
+    void iteration_using_LVG (
+        const Matrix<Real>   &abundance,
+        const Thermodynamics &thermodynamics,
+        const Real1          &velocity_gradient,
+        const Real1          &cell_size         );
+
     void iteration_using_statistical_equilibrium (
-        const Double2      &abundance,
+        const Matrix<Real> &abundance,
         const Vector<Real> &temperature,
         const Real          pop_prec             );
 
     void iteration_using_Ng_acceleration (
         const Real pop_prec              );
 
-    inline Size      index (const Size p, const Size line_index     ) const;
-    inline Size line_index (              const Size l, const Size k) const;
-    inline Size      index (const Size p, const Size l, const Size k) const;
+    inline Index      index (const Size p, const Size line_index     ) const;
+    inline Size  line_index (              const Size l, const Size k) const;
+    inline Index      index (const Size p, const Size l, const Size k) const;
 
     inline void set_emissivity_and_opacity ();
+    inline void set_emissivity_and_opacity (const Size p);
     inline void set_inverse_width (const Thermodynamics& thermodynamics);
 
     void gather_emissivities_and_opacities ();
@@ -6,9 +6,9 @@
 ///    @param[in] p          : index of the point
 ///    @param[in] line_index : index of the line
 /////////////////////////////////////////////////
-inline Size Lines :: index (const Size p, const Size line_index) const
+inline Index Lines :: index (const Size p, const Size line_index) const
 {
-    return line_index + p*parameters.nlines();
+    return line_index + ((Index) p)*parameters.nlines();
 }
 
 
@@ -27,7 +27,7 @@ inline Size Lines :: line_index (const Size l, const Size k) const
 ///    @param[in] l : index of the line producing species
 ///    @param[in] k : index of the line transition
 /////////////////////////////////////// /////////////////////////////
-inline Size Lines :: index (const Size p, const Size l, const Size k) const
+inline Index Lines :: index (const Size p, const Size l, const Size k) const
 {
     return index (p, line_index (l, k));
 }
@@ -53,6 +53,24 @@ inline void Lines :: set_emissivity_and_opacity ()
 }
 
 
+///  Setter for line emissivity and opacity in a single point
+///    @param[in] p : index of the point
+/////////////////////////////////////////////////////////////
+inline void Lines :: set_emissivity_and_opacity (const Size p)
+{
+    for (Size l = 0; l < parameters.nlspecs(); l++)
+    {
+        for (Size k = 0; k < lineProducingSpecies[l].linedata.nrad; k++)
+        {
+            const Size lid = line_index (l, k);
+
+            emissivity (p, lid) = lineProducingSpecies[l].get_emissivity (p, k);
+               opacity (p, lid) = lineProducingSpecies[l].get_opacity    (p, k);
+        }
+    }
+}
+
+
 ///  Setter for line widths
 ///    @param[in] thermodynamics : reference to thermodynamics module
 /////////////////////////////////////////////////////////////////////
@@ -1,10 +1,29 @@
+#include <Eigen/Eigenvalues>
+
 #include "paracabs.hpp"
 #include "model.hpp"
 #include "tools/heapsort.hpp"
+#include "tools/timer.hpp"
+#include "tools/numa.hpp"
+#include "tools/kdtree.hpp"
 #include "solver/solver.hpp"
 
 
 void Model :: read (const Io& io)
+{
+    read (io, false);
+}
+
+
+///  Reader for the model
+///  The geometry, chemistry, thermodynamics and lines are independent given
+///  the number of points, so they are read concurrently if the io allows it.
+///  With lazy loading, optional data (previous populations and collision
+///  partners) is only read when first needed.
+///    @param[in] io   : io object to read with
+///    @param[in] lazy : true to defer reading the optional data
+/////////////////////////////////////////////////////////////////////////////
+void Model :: read (const Io& io, const bool lazy)
 {
     cout << "                                           " << endl;
     cout << "-------------------------------------------" << endl;
@@ -13,12 +32,75 @@ void Model :: read (const Io& io)
     cout << " model file = " << io.io_file                << endl;
     cout << "-------------------------------------------" << endl;
 
-    parameters    .read (io);
-    geometry      .read (io);
-    chemistry     .read (io);
-    thermodynamics.read (io);
-    lines         .read (io);
-    radiation     .read (io);
+    Timer timer_total          ("reading model         ");
+    Timer timer_parameters     ("  parameters          ");
+    Timer timer_geometry       ("  geometry            ");
+    Timer timer_chemistry      ("  chemistry           ");
+    Timer timer_thermodynamics ("  thermodynamics      ");
+    Timer timer_lines          ("  lines               ");
+    Timer timer_radiation      ("  radiation           ");
+    Timer timer_first_touch    ("  first touch         ");
+
+    timer_total.start();
+
+    timer_parameters.start();
+    parameters.read (io);
+    // All sections need the number of points to size their data. It is set here,
+    // before the sections are read concurrently, such that the readers of the
+    // sections, which set it again, only compare it against the global value.
+    // The other counts are each set by a single section (and only read after).
+    parameters.set_npoints (io.get_length ("geometry/points/position"));
+    timer_parameters.stop();
+
+#   pragma omp parallel sections default (shared) if (io.is_thread_safe())
+    {
+#       pragma omp section
+        {
+            timer_geometry.start();
+            geometry.read (io);
+            timer_geometry.stop();
+        }
+#       pragma omp section
+        {
+            timer_chemistry.start();
+            chemistry.read (io);
+            timer_chemistry.stop();
+        }
+#       pragma omp section
+        {
+            timer_thermodynamics.start();
+            thermodynamics.read (io);
+            timer_thermodynamics.stop();
+        }
+#       pragma omp section
+        {
+            timer_lines.start();
+            lines.read (io, lazy);
+            timer_lines.stop();
+        }
+    }
+
+    // Radiation needs the number of lines and rays
+    timer_radiation.start();
+    radiation.read (io);
+    timer_radiation.stop();
+
+    // Place the origin-indexed arrays with the threads that solve for those points
+    // (only useful with more than one thread, otherwise it only costs time). The
+    // line data (emissivity, opacity and widths) is read along entire rays, i.e.
+    // by all threads, so it is left where it was placed.
+    timer_first_touch.start();
+    if (paracabs::multi_threading::n_threads_avail() > 1)
+    {
+        first_touch (radiation.frequencies.nu,      1, parameters.npoints(), parameters.nfreqs());
+        first_touch (radiation.I, parameters.nrays (), parameters.npoints(), parameters.nfreqs());
+        first_touch (radiation.u, parameters.hnrays(), parameters.npoints(), parameters.nfreqs());
+        first_touch (radiation.v, parameters.hnrays(), parameters.npoints(), parameters.nfreqs());
+        first_touch (radiation.J,                   1, parameters.npoints(), parameters.nfreqs());
+    }
+    timer_first_touch.stop();
+
+    timer_total.stop();
 
     cout << "                                           " << endl;
     cout << "-------------------------------------------" << endl;
@@ -35,6 +117,15 @@ void Model :: read (const Io& io)
     cout << "  nlines     = " << parameters.nlines     () << endl;
     cout << "  nquads     = " << parameters.nquads     () << endl;
     cout << "-------------------------------------------" << endl;
+    timer_total         .print();
+    timer_parameters    .print();
+    timer_geometry      .print();
+    timer_chemistry     .print();
+    timer_thermodynamics.print();
+    timer_lines         .print();
+    timer_radiation     .print();
+    timer_first_touch   .print();
+    cout << "-------------------------------------------" << endl;
     cout << "                                           " << endl;
 }
 
@@ -127,11 +218,11 @@ int Model :: compute_spectral_discretisation ()
 
         for (Size l = 0; l < parameters.nlspecs(); l++)
         {
-            for (Size k = 0; k < lines.lineProducingSpecies[l].nr_line[p].size(); k++)
+            for (Size k = 0; k < lines.lineProducingSpecies[l].linedata.nrad; k++)
             {
-                for (Size z = 0; z < lines.lineProducingSpecies[l].nr_line[p][k].size(); z++)
+                for (Size z = 0; z < parameters.nquads(); z++)
                 {
-                    lines.lineProducingSpecies[l].nr_line[p][k][z] = nmbrs_inverted[index2];
+                    lines.lineProducingSpecies[l].nr_line(p,k,z) = nmbrs_inverted[index2];
 
                     radiation.frequencies.appears_in_line_integral[index2] = true;
                     radiation.frequencies.corresponding_l_for_spec[index2] = l;
@@ -219,11 +310,11 @@ int Model :: compute_spectral_discretisation (const Real width)
 
         for (Size l = 0; l < parameters.nlspecs(); l++)
         {
-            for (Size k = 0; k < lines.lineProducingSpecies[l].nr_line[p].size(); k++)
+            for (Size k = 0; k < lines.lineProducingSpecies[l].linedata.nrad; k++)
             {
-                for (Size z = 0; z < lines.lineProducingSpecies[l].nr_line[p][k].size(); z++)
+                for (Size z = 0; z < parameters.nquads(); z++)
                 {
-                    lines.lineProducingSpecies[l].nr_line[p][k][z] = nmbrs_inverted[index2];
+                    lines.lineProducingSpecies[l].nr_line(p,k,z) = nmbrs_inverted[index2];
 
                     radiation.frequencies.appears_in_line_integral[index2] = true;
                     radiation.frequencies.corresponding_l_for_spec[index2] = l;
@@ -289,6 +380,138 @@ int Model :: compute_LTE_level_populations ()
 }
 
 
+///  Compute level populations in the large velocity gradient (LVG) approximation
+///  Cheap, local initial guess for compute_level_populations, better than LTE
+///  for sub-thermally excited lines. The line of sight velocity gradient is
+///  estimated as the mean over the neighbours of each point.
+////////////////////////////////////////////////////////////////////////////////
+int Model :: compute_LVG_level_populations ()
+{
+    // Start from LTE (sets the total populations and the initial opacities)
+    compute_LTE_level_populations ();
+
+    cout << "Computing LVG level populations..." << endl;
+
+    Real1 velocity_gradient (parameters.npoints());
+    Real1 cell_size         (parameters.npoints());
+
+    threaded_for (p, parameters.npoints(),
+    {
+        const Size n_nbs = geometry.points.n_neighbors[p];
+
+        Real gradient = 0.0;
+        Real distance = 0.0;
+
+        for (Size i = 0; i < n_nbs; i++)
+        {
+            const Size     n  = geometry.points.neighbors[geometry.points.cum_n_neighbors[p]+i];
+            const Vector3D R  = geometry.points.position[n] - geometry.points.position[p];
+            const double   R2 = R.dot(R);
+
+            gradient += fabs ((geometry.points.velocity[n] - geometry.points.velocity[p]).dot(R)) / R2;
+            distance += sqrt (R2);
+        }
+
+        velocity_gradient[p] = (n_nbs > 0) ? gradient / n_nbs : 0.0;
+        cell_size        [p] = (n_nbs > 0) ? distance / n_nbs : 1.0;
+    })
+
+    lines.iteration_using_LVG (
+        chemistry.species.abundance,
+        thermodynamics,
+        velocity_gradient,
+        cell_size                   );
+
+    return (0);
+}
+
+
+///  Compute level populations by interpolating the (converged) level populations
+///  of another model of the same medium, e.g. on a coarser or an earlier mesh.
+///  The fractional level populations of the nearest points of the source model
+///  (found with a k-d tree) are averaged with inverse distance squared weights.
+///  Only the positions and populations of the source model are used, such that
+///  it can be solved before the target model is read (parameters are global).
+///    @param[in] source    : model with the same line producing species
+///    @param[in] n_nearest : number of nearest source points to interpolate from
+////////////////////////////////////////////////////////////////////////////////
+int Model :: compute_level_populations_from_model (
+    const Model& source,
+    const Size   n_nearest )
+{
+    cout << "Interpolating level populations..." << endl;
+
+    if (source.lines.lineProducingSpecies.size() != lines.lineProducingSpecies.size())
+    {
+        throw std::runtime_error ("Source model has different line producing species!");
+    }
+
+    for (Size l = 0; l < lines.lineProducingSpecies.size(); l++)
+    {
+        if (source.lines.lineProducingSpecies[l].linedata.nlev != lines.lineProducingSpecies[l].linedata.nlev)
+        {
+            throw std::runtime_error ("Source model has different line producing species!");
+        }
+    }
+
+    KdTree tree;
+    tree.build (source.geometry.points.position);
+
+    const Size k = std::min ((Size) source.geometry.points.position.vec.size(), std::max (n_nearest, Size(1)));
+
+    Size2   nearest (parameters.npoints());
+    Double2 weight  (parameters.npoints());
+
+    threaded_for (p, parameters.npoints(),
+    {
+        const double x[3] = {geometry.points.position[p].x(),
+                             geometry.points.position[p].y(),
+                             geometry.points.position[p].z() };
+
+        Double1 dist2;
+
+        tree.get_nearest (x, k, nearest[p], dist2);
+
+        // A coinciding point is copied, otherwise inverse distance weighting
+        if (dist2[0] == 0.0)
+        {
+            nearest[p].resize (1);
+            weight [p].assign (1, 1.0);
+        }
+        else
+        {
+            weight[p].resize (k);
+
+            double weight_tot = 0.0;
+
+            for (Size n = 0; n < k; n++)
+            {
+                weight[p][n] = 1.0 / dist2[n];
+                weight_tot  += weight[p][n];
+            }
+
+            for (Size n = 0; n < k; n++)
+            {
+                weight[p][n] /= weight_tot;
+            }
+        }
+    })
+
+    for (Size l = 0; l < lines.lineProducingSpecies.size(); l++)
+    {
+        lines.lineProducingSpecies[l].update_using_interpolation (
+            chemistry.species.abundance,
+            source.lines.lineProducingSpecies[l],
+            nearest,
+            weight                               );
+    }
+
+    lines.set_emissivity_and_opacity ();
+
+    return (0);
+}
+
+
 ///  Computer for the radiation field
 /////////////////////////////////////
 int Model :: compute_radiation_field_shortchar_order_0 ()
@@ -300,8 +523,10 @@ int Model :: compute_radiation_field_shortchar_order_0 ()
 
     // Solver solver (length_max, width_max, parameters.n_off_diag);
 
+    // Short characteristics only need scratch space per frequency, so there is
+    // no need to trace all rays first to find the maximum ray length
     Solver solver;
-    solver.setup <CoMoving>        (*this);
+    solver.setup                   (1, parameters.nfreqs(), 0);
     solver.solve_shortchar_order_0 (*this);
 
     return (0);
@@ -323,6 +548,51 @@ int Model :: compute_radiation_field_feautrier_order_2 ()
     solver.setup <CoMoving>        (*this);
     solver.solve_feautrier_order_2 (*this);
 
+    if ((parameters.lambda_threshold > 0.0) || (parameters.lambda_max_entries > 0))
+    {
+        for (const LineProducingSpecies& lspec : lines.lineProducingSpecies) {lspec.lambda.print_statistics();}
+    }
+
+    return (0);
+}
+
+
+///  Computer for the radiation field with the 4th-order Feautrier solver
+/////////////////////////////////////////////////////////////////////////
+int Model :: compute_radiation_field_feautrier_order_4 ()
+{
+    cout << "Computing radiation field..." << endl;
+
+    Solver solver;
+    solver.setup <CoMoving>        (*this);
+    solver.solve_feautrier_order_4 (*this);
+
+    if ((parameters.lambda_threshold > 0.0) || (parameters.lambda_max_entries > 0))
+    {
+        for (const LineProducingSpecies& lspec : lines.lineProducingSpecies) {lspec.lambda.print_statistics();}
+    }
+
+    return (0);
+}
+
+
+///  Select the rays to trace in each point with adaptive ray tracing (see
+///  Solver::set_adaptive_rays), given the current level populations. All
+///  subsequent radiation fields are only computed along the selected rays.
+///////////////////////////////////////////////////////////////////////////
+int Model :: compute_adaptive_rays ()
+{
+    if (!parameters.adaptive_ray_tracing())
+    {
+        throw std::runtime_error ("Adaptive ray tracing was not enabled!");
+    }
+
+    cout << "Computing adaptive rays..." << endl;
+
+    Solver solver;
+    solver.setup <CoMoving>  (*this);
+    solver.set_adaptive_rays (*this);
+
     return (0);
 }
 
@@ -331,23 +601,21 @@ int Model :: compute_radiation_field_feautrier_order_2 ()
 ///////////////////////////////////////////////////
 int Model :: compute_Jeff ()
 {
-    for (LineProducingSpecies &lspec : lines.lineProducingSpecies)
+    // Single sweep over the points covering all species, such that the work
+    // of the different species is done concurrently and balanced over threads
+    threaded_for (p, parameters.npoints(),
     {
-       // Lambda = MatrixXd::Zero (lspec.population.size(), lspec.population.size());
-
-        threaded_for (p, parameters.npoints(),
+        for (LineProducingSpecies &lspec : lines.lineProducingSpecies)
         {
             for (Size k = 0; k < lspec.linedata.nrad; k++)
             {
-                const Size1 freq_nrs = lspec.nr_line[p][k];
-
                 // Initialize values
-                lspec.Jlin[p][k] = 0.0;
+                lspec.Jlin(p,k) = 0.0;
 
                 // Integrate over the line
                 for (Size z = 0; z < parameters.nquads(); z++)
                 {
-                    lspec.Jlin[p][k] += lspec.quadrature.weights[z] * radiation.J(p, freq_nrs[z]);
+                    lspec.Jlin(p,k) += lspec.quadrature.weights[z] * radiation.J(p, lspec.nr_line(p,k,z));
                 }
 
 
@@ -356,16 +624,16 @@ int Model :: compute_Jeff ()
                 // Collect the approximated part
                 for (Size m = 0; m < lspec.lambda.get_size(p,k); m++)
                 {
-                    const Size I = lspec.index(lspec.lambda.get_nr(p,k,m), lspec.linedata.irad[k]);
+                    const Index I = lspec.index(lspec.lambda.get_nr(p,k,m), lspec.linedata.irad[k]);
 
                     diff += lspec.lambda.get_Ls(p,k,m) * lspec.population[I];
                 }
 
-                lspec.Jeff[p][k] = lspec.Jlin[p][k] - HH_OVER_FOUR_PI * diff;
-                lspec.Jdif[p][k] = HH_OVER_FOUR_PI * diff;
+                lspec.Jeff(p,k) = lspec.Jlin(p,k) - HH_OVER_FOUR_PI * diff;
+                lspec.Jdif(p,k) = HH_OVER_FOUR_PI * diff;
             }
-        })
-    }
+        }
+    })
 
     return (0);
 }
@@ -385,7 +653,9 @@ int Model :: compute_level_populations_from_stateq ()
 
 
 ///  Compute level populations self-consistenly with the radiation field
-///  assuming statistical equilibrium (detailed balance for the levels)
+///  assuming statistical equilibrium (detailed balance for the levels).
+///  With parameters.first_stage_shortchar, the iterations start with the short-
+///  characteristics solver and continue with Feautrier once they converged.
 ///  @param[in] io                  : io object (for writing level populations)
 ///  @param[in] use_Ng_acceleration : true if Ng acceleration has to be used
 ///  @param[in] max_niterations     : maximum number of iterations
@@ -412,9 +682,21 @@ int Model :: compute_level_populations (
     // Initialize some_not_converged
     bool some_not_converged = true;
 
+    // Start with the (cheaper) short-characteristics solver if requested
+    bool first_stage = parameters.first_stage_shortchar;
+
     // Iterate as long as some levels are not converged
-    while (some_not_converged && (iteration < max_niterations))
+    while ((some_not_converged || first_stage) && (iteration < max_niterations))
     {
+        // Switch to the Feautrier solver once the first stage has converged
+        if (first_stage && !some_not_converged)
+        {
+            cout << "First stage converged, switching to the Feautrier solver..." << endl;
+
+            first_stage      = false;
+            iteration_normal = 0;
+        }
+
         iteration++;
 
         // logger.write ("Starting iteration ", iteration);
@@ -434,8 +716,16 @@ int Model :: compute_level_populations (
             // logger.write ("Computing the radiation field...");
             cout << "Computing the radiation field..." << endl;
 
-            compute_radiation_field_feautrier_order_2 ();
-            compute_Jeff                              ();
+            if (first_stage)
+            {
+                compute_radiation_field_shortchar_order_0 ();
+            }
+            else
+            {
+                compute_radiation_field_feautrier_order_2 ();
+            }
+
+            compute_Jeff ();
 
             lines.iteration_using_statistical_equilibrium (
                 chemistry.species.abundance,
@@ -470,6 +760,310 @@ int Model :: compute_level_populations (
 }
 
 
+///  Compute level populations self-consistenly with the radiation field using
+///  Gauss-Seidel sweeps over the points. The points are ordered along the first
+///  ray direction and split in blocks, sweeping alternately forward and backward.
+///  The level populations in a block are updated as soon as its radiation field
+///  is known, such that all subsequent blocks already see the new populations.
+///  Only the local part of the ALO is treated implicitly.
+///  @param[in] max_niterations : maximum number of sweeps
+///  @return number of sweeps done
+///////////////////////////////////////////////////////////////////////////////
+int Model :: compute_level_populations_gauss_seidel (const long max_niterations)
+{
+    // Check spectral discretisation setting
+    if (spectralDiscretisation != SD_Lines)
+    {
+        throw std::runtime_error ("Spectral discretisation was not set for Lines!");
+    }
+
+    lines.read_deferred_data ();
+
+    const Size npoints = parameters.npoints();
+    const Size nblocks = std::min ((long) npoints, std::max (1L, parameters.n_sweep_blocks));
+
+    // Order the points along the first ray direction
+    Double1 projection (npoints);
+    Size1   order      (npoints);
+
+    for (Size p = 0; p < npoints; p++)
+    {
+        projection[p] = geometry.points.position[p].dot(geometry.rays.direction[0]);
+        order     [p] = p;
+    }
+
+    heapsort (projection, order);
+
+    // Initialize the number of iterations
+    int iteration = 0;
+
+    // Initialize errors
+    error_mean.clear ();
+    error_max .clear ();
+
+    // Initialize some_not_converged
+    bool some_not_converged = true;
+
+    // Iterate as long as some levels are not converged
+    while (some_not_converged && (iteration < max_niterations))
+    {
+        iteration++;
+
+        cout << "Starting sweep " << iteration << endl;
+
+        // Start assuming convergence
+        some_not_converged = false;
+
+        for (LineProducingSpecies &lspec : lines.lineProducingSpecies)
+        {
+            lspec.population_prev3 = lspec.population_prev2;
+            lspec.population_prev2 = lspec.population_prev1;
+            lspec.population_prev1 = lspec.population;
+        }
+
+        Solver solver;
+        solver.setup <CoMoving> (*this);
+
+        for (Size b = 0; b < nblocks; b++)
+        {
+            // Alternate the direction of the sweep
+            const Size b_sweep = (iteration % 2) ? b : nblocks-1-b;
+
+            const Size start = ( b_sweep   *npoints)/nblocks;
+            const Size stop  = ((b_sweep+1)*npoints)/nblocks;
+
+            Vector<Size> block;
+            block.resize (stop-start);
+
+            for (Size i = 0; i < stop-start; i++)
+            {
+                block.vec[i] = order[start+i];
+            }
+
+            block.copy_vec_to_ptr ();
+
+            // Radiation field in the block, with the latest populations
+            solver.solve_feautrier_order_2 (*this, block);
+
+            // Local statistical equilibrium in the block
+            for (Size i = 0; i < stop-start; i++)
+            {
+                const Size p = block.vec[i];
+
+                for (LineProducingSpecies &lspec : lines.lineProducingSpecies)
+                {
+                    for (Size k = 0; k < lspec.linedata.nrad; k++)
+                    {
+                        lspec.Jlin(p,k) = 0.0;
+
+                        for (Size z = 0; z < parameters.nquads(); z++)
+                        {
+                            lspec.Jlin(p,k) += lspec.quadrature.weights[z] * radiation.J(p, lspec.nr_line(p,k,z));
+                        }
+                    }
+
+                    lspec.update_using_statistical_equilibrium (
+                        chemistry.species.abundance,
+                        thermodynamics.temperature.gas,
+                        p                              );
+                }
+
+                lines.set_emissivity_and_opacity (p);
+            }
+        }
+
+        for (int l = 0; l < parameters.nlspecs(); l++)
+        {
+            lines.lineProducingSpecies[l].check_for_convergence (parameters.pop_prec());
+
+            error_mean.push_back (lines.lineProducingSpecies[l].relative_change_mean);
+            error_max .push_back (lines.lineProducingSpecies[l].relative_change_max);
+
+            if (lines.lineProducingSpecies[l].fraction_not_converged > 0.005)
+            {
+                some_not_converged = true;
+            }
+
+            const double fnc = lines.lineProducingSpecies[l].fraction_not_converged;
+
+            cout << "Already " << 100 * (1.0 - fnc) << " % converged!" << endl;
+        }
+    } // end of while loop of sweeps
+
+    // Print convergence stats
+    cout << "Converged after " << iteration << " sweeps" << endl;
+
+    return iteration;
+}
+
+
+///  Compute level populations after a perturbation of the temperature, abundances
+///  or velocities in a set of points, starting from the previously converged
+///  populations and radiation field (J, u and Lambda of the last Feautrier solve).
+///  Only the ray pairs passing through a point of which the populations changed
+///  are solved again, and only the origins of those ray pairs update their
+///  populations, until the perturbation has propagated and converged.
+///  @param[in] modified        : indices of the perturbed points
+///  @param[in] max_niterations : maximum number of iterations
+///  @return number of iterations done
+///////////////////////////////////////////////////////////////////////////////////
+int Model :: compute_level_populations_incremental (
+    const Size1& modified,
+    const long   max_niterations )
+{
+    // Check spectral discretisation setting
+    if (spectralDiscretisation != SD_Lines)
+    {
+        throw std::runtime_error ("Spectral discretisation was not set for Lines!");
+    }
+
+    lines.read_deferred_data ();
+
+    const Size npoints = parameters.npoints();
+
+    // Line widths and frequencies depend on the (perturbed) temperature
+    compute_inverse_line_widths     ();
+    compute_spectral_discretisation ();
+
+    if (geometry.use_projected_velocities)
+    {
+        geometry.set_projected_velocities ();
+    }
+
+    Char1 changed (npoints, false);
+
+    // Rescale the populations of the perturbed points to their new abundances
+    for (const Size p : modified)
+    {
+        for (LineProducingSpecies &lspec : lines.lineProducingSpecies)
+        {
+            const Real population_tot = chemistry.species.abundance(p, lspec.linedata.num);
+
+            for (Size i = 0; i < lspec.linedata.nlev; i++)
+            {
+                lspec.population(lspec.index(p,i)) *= population_tot / lspec.population_tot[p];
+            }
+
+            lspec.population_tot[p] = population_tot;
+        }
+
+        lines.set_emissivity_and_opacity (p);
+
+        changed[p] = true;
+    }
+
+    // Initialize errors
+    error_mean.clear ();
+    error_max .clear ();
+
+    Solver solver;
+    solver.setup <CoMoving> (*this);
+
+    Size1   n_pairs;
+    Double1 change_p (npoints);
+
+    int  iteration  = 0;
+    Size n_changed  = modified.size();
+
+    while ((n_changed > 0) && (iteration < max_niterations))
+    {
+        iteration++;
+
+        // Radiation field along the ray pairs through the changed points, caching
+        // the paths of the ray pairs through the modified points (first iteration)
+        solver.cache_paths = (iteration == 1);
+        solver.solve_feautrier_order_2 (*this, changed, n_pairs);
+
+        Size n_resolved = 0;
+        Size n_origins  = 0;
+
+        double change_max  = 0.0;
+        double change_mean = 0.0;
+
+        n_changed = 0;
+
+        // Statistical equilibrium in the origins of those ray pairs (each point
+        // only writes its own data, the statistics are reduced afterwards)
+        threaded_for (p, npoints,
+        {
+            change_p[p] = 0.0;
+
+            if (n_pairs[p] > 0)
+            {
+                for (LineProducingSpecies &lspec : lines.lineProducingSpecies)
+                {
+                    for (Size k = 0; k < lspec.linedata.nrad; k++)
+                    {
+                        lspec.Jlin(p,k) = 0.0;
+
+                        for (Size z = 0; z < parameters.nquads(); z++)
+                        {
+                            lspec.Jlin(p,k) += lspec.quadrature.weights[z] * radiation.J(p, lspec.nr_line(p,k,z));
+                        }
+                    }
+
+                    Real1 population_prev (lspec.linedata.nlev);
+
+                    for (Size i = 0; i < lspec.linedata.nlev; i++)
+                    {
+                        population_prev[i] = lspec.population(lspec.index(p,i));
+                    }
+
+                    lspec.update_using_statistical_equilibrium (
+                        chemistry.species.abundance,
+                        thermodynamics.temperature.gas,
+                        p                              );
+
+                    const double min_pop = 1.0E-10 * lspec.population_tot[p];
+
+                    for (Size i = 0; i < lspec.linedata.nlev; i++)
+                    {
+                        const Real pop = lspec.population(lspec.index(p,i));
+
+                        if (pop > min_pop)
+                        {
+                            change_p[p] = std::max (change_p[p], (double) (2.0 * fabs (pop - population_prev[i]) / (pop + population_prev[i])));
+                        }
+                    }
+                }
+
+                lines.set_emissivity_and_opacity (p);
+            }
+        })
+
+        for (Size p = 0; p < npoints; p++)
+        {
+            changed[p] = false;
+
+            if (n_pairs[p] == 0) {continue;}
+
+            n_resolved += n_pairs[p];
+            n_origins  += 1;
+
+            if (change_p[p] > parameters.pop_prec())
+            {
+                changed[p] = true;
+                n_changed++;
+            }
+
+            change_max   = std::max (change_max, change_p[p]);
+            change_mean += change_p[p];
+        }
+
+        error_mean.push_back (change_mean / std::max (n_origins, Size(1)));
+        error_max .push_back (change_max);
+
+        cout << "Iteration " << iteration << ": re-solved " << n_resolved << " ray pairs in "
+             << n_origins << " points, populations changed in " << n_changed << " points" << endl;
+    }
+
+    // Print convergence stats
+    cout << "Converged after " << iteration << " iterations" << endl;
+
+    return iteration;
+}
+
+
 ///  Computer for the radiation field
 /////////////////////////////////////
 int Model :: compute_image (const Size ray_nr)
@@ -489,6 +1083,435 @@ int Model :: compute_image (const Size ray_nr)
 }
 
 
+///  Computer for an image with the (cheaper) first-order formal solver
+///    @param[in] ray_nr : number of the ray along which the image is taken
+/////////////////////////////////////////////////////////////////////////
+int Model :: compute_image_shortchar_order_1 (const Size ray_nr)
+{
+    cout << "Computing image..." << endl;
+
+    Solver solver;
+    solver.setup <Rest>            (*this);
+    solver.image_shortchar_order_1 (*this, ray_nr);
+
+    return (0);
+}
+
+
+///  Setter for a Gauss-Hermite quadrature with n (<= nquads) points in all line
+///  producing species, with the roots and weights from the Golub-Welsch method.
+///  The remaining quadrature points get zero weight (on the outermost root),
+///  such that they do not contribute.
+///    @param[in,out] model : model to set the quadrature in
+///    @param[in]     n     : number of quadrature points
+/////////////////////////////////////////////////////////////////////////////////
+inline void set_reduced_quadrature (Model& model, const Size n)
+{
+    // The roots are the eigenvalues of the Jacobi matrix of the Hermite polynomials
+    Eigen::MatrixXd jacobi = Eigen::MatrixXd::Zero (n, n);
+
+    for (Size i = 1; i < n; i++)
+    {
+        jacobi(i, i-1) = sqrt (0.5*i);
+        jacobi(i-1, i) = sqrt (0.5*i);
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen (jacobi);
+
+    for (LineProducingSpecies& lspec : model.lines.lineProducingSpecies)
+    {
+        for (Size z = 0; z < model.parameters.nquads(); z++)
+        {
+            const Size i = (z < n) ? z : n-1;
+
+            lspec.quadrature.roots  .vec[z] = eigen.eigenvalues()(i);
+            lspec.quadrature.weights.vec[z] = (z < n) ? eigen.eigenvectors()(0,i) * eigen.eigenvectors()(0,i) : 0.0;
+        }
+
+        lspec.quadrature.roots  .copy_vec_to_ptr ();
+        lspec.quadrature.weights.copy_vec_to_ptr ();
+    }
+}
+
+
+///  Setter for the (uniform) subset of the HEALPix rays of the given order, by
+///  giving only the rays closest to the centres of its pixels a non-zero weight
+///    @param[in,out] model : model to set the rays in
+///    @param[in]     order : HEALPix order of the subset (<= order of the rays)
+///////////////////////////////////////////////////////////////////////////////
+inline void set_reduced_rays (Model& model, const Size order)
+{
+    Rays& rays = model.geometry.rays;
+
+    rays.adaptive = (order < rays.order);
+
+    if (!rays.adaptive) {return;}
+
+    const Size hnrays = model.parameters.hnrays();
+    const Size shift  = 2*(rays.order-order);
+
+    rays.point_weight.resize (hnrays, model.parameters.npoints());
+
+    threaded_for (o, model.parameters.npoints(),
+    {
+        for (Size rr = 0; rr < hnrays; rr++)
+        {
+            rays.point_weight(rr,o) = 0.0;
+        }
+
+        for (const Size r : rays.nested_ray[order])
+        {
+            if (r < hnrays)
+            {
+                rays.point_weight(r,o) = rays.weight[r] * (Size(1) << shift);
+            }
+        }
+    })
+}
+
+
+///  Getter for the maximum relative difference between two sets of values
+///    @param[in] a : values
+///    @param[in] b : reference values
+///    @return maximum relative difference
+//////////////////////////////////////////////////////////////////////////
+inline double max_relative_error (const Real1& a, const Real1& b)
+{
+    double error = 0.0;
+
+    for (Size i = 0; i < b.size(); i++)
+    {
+        if (b[i] != 0.0)
+        {
+            error = std::max (error, (double) fabs ((a[i] - b[i]) / b[i]));
+        }
+    }
+
+    return error;
+}
+
+
+///  Tuner for the solver parameters: propose the cheapest configuration of the
+///  number of rays, the number of quadrature points, the max_width_fraction and
+///  n_off_diag for which the line mean intensities (Jlin) are within the given
+///  tolerance of those of a high-resolution reference (all rays, all quadrature
+///  points and max_width_fraction = 0.125), based on short trial solves.
+///  The trials for the radiation field are only solved in a subsample of the
+///  points (every subsample-th point as origin), which makes them cheaper by
+///  about that factor, while the ray paths still cross the full model.
+///  The fewer rays are a (nested) subset of the HEALPix rays of the model, the
+///  fewer quadrature points a new Gauss-Hermite quadrature. Since nrays and
+///  nquads are fixed by the model data, they can only be proposed (as
+///  tuned_nrays and tuned_nquads) for the setup of the next model (see
+///  set_tuned_solver_parameters in magritte/setup.py). The reduced quadratures
+///  are emulated by giving the remaining points zero weight, so their trials
+///  are not cheaper, and their cost is taken to be proportional to the number
+///  of points. n_off_diag does not change the radiation field, so it is chosen
+///  as the one for which the level populations converge fastest (in measured
+///  wall time, in at most max_niterations), provided they agree with those of
+///  the largest n_off_diag. Its trials solve the full model, each starting from
+///  the state of the model before tuning, which is also restored at the end.
+///    @param[in] tolerance       : maximum relative error in Jlin (and populations)
+///    @param[in] max_niterations : maximum number of iterations in the trials for
+///                                 n_off_diag (0 = do not tune n_off_diag)
+///    @param[in] subsample       : solve the radiation field trials only in every
+///                                 subsample-th point (1 = in all points)
+///    @return number of trial solves
+//////////////////////////////////////////////////////////////////////////////////
+int Model :: tune_solver_parameters (
+    const double tolerance,
+    const long   max_niterations,
+    const Size   subsample       )
+{
+    cout << "Tuning solver parameters..." << endl;
+
+    // Check spectral discretisation setting
+    if (spectralDiscretisation != SD_Lines)
+    {
+        throw std::runtime_error ("Spectral discretisation was not set for Lines!");
+    }
+
+    Rays& rays = geometry.rays;
+
+    if (rays.adaptive)
+    {
+        throw std::runtime_error ("Tuning the solver parameters is not possible with adaptive rays!");
+    }
+
+    if (subsample < 1)
+    {
+        throw std::runtime_error ("The subsample factor should be at least 1.");
+    }
+
+    const Size nquads = parameters.nquads();
+
+    // Store the state that is changed by the trials
+    vector<Real1>            roots_0;
+    vector<Real1>            weights_0;
+    vector<VectorXr>         population_0;
+    vector<VectorXr>         population_prev1_0;
+    vector<VectorXr>         population_prev2_0;
+    vector<VectorXr>         population_prev3_0;
+    vector<vector<VectorXr>> populations_0;
+    vector<vector<VectorXr>> residuals_0;
+
+    for (const LineProducingSpecies& lspec : lines.lineProducingSpecies)
+    {
+        roots_0           .push_back (lspec.quadrature.roots  .vec);
+        weights_0         .push_back (lspec.quadrature.weights.vec);
+        population_0      .push_back (lspec.population      );
+        population_prev1_0.push_back (lspec.population_prev1);
+        population_prev2_0.push_back (lspec.population_prev2);
+        population_prev3_0.push_back (lspec.population_prev3);
+        populations_0     .push_back (lspec.populations     );
+        residuals_0       .push_back (lspec.residuals       );
+    }
+
+    // Restore the level populations (and with them the emissivities and opacities)
+    auto restore_populations = [&] ()
+    {
+        for (Size l = 0; l < parameters.nlspecs(); l++)
+        {
+            LineProducingSpecies& lspec = lines.lineProducingSpecies[l];
+
+            lspec.population       = population_0      [l];
+            lspec.population_prev1 = population_prev1_0[l];
+            lspec.population_prev2 = population_prev2_0[l];
+            lspec.population_prev3 = population_prev3_0[l];
+            lspec.populations      = populations_0     [l];
+            lspec.residuals        = residuals_0       [l];
+        }
+
+        lines.set_emissivity_and_opacity ();
+    };
+
+    // Origins in which the radiation field trials are solved
+    Vector<Size> origins;
+    origins.resize ((parameters.npoints() + subsample - 1) / subsample);
+
+    for (Size i = 0; i < origins.size(); i++)
+    {
+        origins[i] = i * subsample;
+    }
+
+    origins.copy_vec_to_ptr ();
+
+    // Candidates for each parameter, from cheap to expensive (last = reference)
+    Size1 orders;
+
+    try
+    {
+        rays.set_nested_rays ();
+
+        for (Size l = 0; l <= rays.order; l++) {orders.push_back (l);}
+    }
+    catch (const std::runtime_error&)
+    {
+        cout << "The rays are not HEALPix rays, only tuning for all rays." << endl;
+
+        orders.push_back (rays.order);
+    }
+
+    Size1 quads;
+
+    for (Size n = 1; n < nquads; n += 2) {quads.push_back (n);}
+
+    quads.push_back (nquads);
+
+    const Double1 widths = {1.0, 0.5, 0.25, 0.125};
+
+    // Trial solve for the radiation field (the Lambda operator is not required)
+    long n_off_diag = parameters.n_off_diag;
+
+    parameters.n_off_diag = 0;
+
+    int ntrials = 0;
+
+    auto trial = [&] (const Size order, const Size n, const double width, double& time)
+    {
+        set_reduced_rays       (*this, order);
+        set_reduced_quadrature (*this, n);
+        compute_spectral_discretisation ();
+
+        parameters.max_width_fraction = width;
+
+        singleTimer timer;
+        timer.start();
+
+        Solver solver;
+        solver.setup <CoMoving>        (*this);
+        solver.solve_feautrier_order_2 (*this, origins);
+
+        timer.stop();
+
+        time = timer.get_interval();
+
+        ntrials++;
+
+        // Line mean intensities in the origins
+        Real1 Jlin;
+
+        for (const LineProducingSpecies& lspec : lines.lineProducingSpecies)
+        {
+            for (Size i = 0; i < origins.size(); i++)
+            {
+                for (Size k = 0; k < lspec.linedata.nrad; k++)
+                {
+                    Real J = 0.0;
+
+                    for (Size z = 0; z < nquads; z++)
+                    {
+                        J += lspec.quadrature.weights[z] * radiation.J(origins[i], lspec.nr_line(origins[i],k,z));
+                    }
+
+                    Jlin.push_back (J);
+                }
+            }
+        }
+
+        return Jlin;
+    };
+
+    double time_ref;
+
+    const Real1 Jlin_ref = trial (orders.back(), quads.back(), widths.back(), time_ref);
+
+    // Error of each candidate, with the other parameters at their reference
+    Double1 error_orders (orders.size(), 0.0);
+    Double1 error_quads  (quads .size(), 0.0);
+    Double1 error_widths (widths.size(), 0.0);
+
+    double time;
+
+    for (Size i = 0; i < orders.size()-1; i++)
+    {
+        error_orders[i] = max_relative_error (trial (orders[i], quads.back(), widths.back(), time), Jlin_ref);
+        cout << "  nrays  = " << 12*(Size(1) << (2*orders[i])) << " : error = " << error_orders[i] << ", time = " << time << " s" << endl;
+    }
+
+    for (Size i = 0; i < quads.size()-1; i++)
+    {
+        error_quads[i] = max_relative_error (trial (orders.back(), quads[i], widths.back(), time), Jlin_ref);
+        cout << "  nquads = " << quads[i] << " : error = " << error_quads[i] << endl;
+    }
+
+    for (Size i = 0; i < widths.size()-1; i++)
+    {
+        error_widths[i] = max_relative_error (trial (orders.back(), quads.back(), widths[i], time), Jlin_ref);
+        cout << "  max_width_fraction = " << widths[i] << " : error = " << error_widths[i] << ", time = " << time << " s" << endl;
+    }
+
+    // Split the tolerance over the parameters, and halve the share of each
+    // parameter as long as the combination of the cheapest choices fails
+    Size i_order = orders.size()-1;
+    Size i_quad  = quads .size()-1;
+    Size i_width = widths.size()-1;
+
+    double error = 0.0;
+
+    for (double share = tolerance / 3.0; share > tolerance / 48.0; share *= 0.5)
+    {
+        i_order = 0; while (error_orders[i_order] > share) {i_order++;}
+        i_quad  = 0; while (error_quads [i_quad ] > share) {i_quad ++;}
+        i_width = 0; while (error_widths[i_width] > share) {i_width++;}
+
+        error = max_relative_error (trial (orders[i_order], quads[i_quad], widths[i_width], time), Jlin_ref);
+
+        if (error <= tolerance) {break;}
+
+        // Fall back to the reference if no combination is found
+        i_order = orders.size()-1;
+        i_quad  = quads .size()-1;
+        i_width = widths.size()-1;
+
+        error = 0.0;
+    }
+
+    set_reduced_rays       (*this, orders[i_order]);
+    set_reduced_quadrature (*this, quads [i_quad ]);
+    compute_spectral_discretisation ();
+
+    parameters.max_width_fraction = widths[i_width];
+
+    // Choose n_off_diag as the one for which the level populations converge fastest
+    if (max_niterations > 0)
+    {
+        const long max_n_off_diag = 2;
+
+        vector<Real1> populations (max_n_off_diag+1);
+
+        double time_best = std::numeric_limits<double>::max();
+
+        for (long n = max_n_off_diag; n >= 0; n--)
+        {
+            parameters.n_off_diag = n;
+
+            // Start every trial from the same state
+            restore_populations ();
+
+            singleTimer timer;
+            timer.start();
+            const int niterations = compute_level_populations (parameters.use_Ng_acceleration(), max_niterations);
+            timer.stop();
+
+            time = timer.get_interval();
+
+            ntrials++;
+
+            for (const LineProducingSpecies& lspec : lines.lineProducingSpecies)
+            {
+                for (Size i = 0; i < lspec.population.size(); i++)
+                {
+                    populations[n].push_back (lspec.population(i));
+                }
+            }
+
+            const double error_pops = max_relative_error (populations[n], populations[max_n_off_diag]);
+
+            cout << "  n_off_diag = " << n << " : " << niterations << " iterations, error = " << error_pops << ", time = " << time << " s" << endl;
+
+            if ((error_pops <= tolerance) && (time <= time_best))
+            {
+                n_off_diag = n;
+                time_best  = time;
+            }
+        }
+    }
+
+    // Restore the model
+    for (Size l = 0; l < parameters.nlspecs(); l++)
+    {
+        LineProducingSpecies& lspec = lines.lineProducingSpecies[l];
+
+        lspec.quadrature.roots  .vec = roots_0  [l];
+        lspec.quadrature.weights.vec = weights_0[l];
+
+        lspec.quadrature.roots  .copy_vec_to_ptr ();
+        lspec.quadrature.weights.copy_vec_to_ptr ();
+    }
+
+    restore_populations ();
+
+    rays.adaptive = false;
+
+    compute_spectral_discretisation ();
+
+    // Write the proposed configuration to the parameters
+    parameters.n_off_diag         = n_off_diag;
+    parameters.max_width_fraction = widths[i_width];
+    parameters.tuned_nquads       = quads [i_quad];
+    parameters.tuned_nrays        = (orders.size() > 1) ? 12*(Size(1) << (2*orders[i_order])) : parameters.nrays();
+
+    cout << "Proposed solver parameters (error = " << error << ", reference time = " << time_ref << " s):" << endl;
+    cout << "  nrays              = " << parameters.tuned_nrays        << endl;
+    cout << "  nquads             = " << parameters.tuned_nquads       << endl;
+    cout << "  max_width_fraction = " << parameters.max_width_fraction << endl;
+    cout << "  n_off_diag         = " << parameters.n_off_diag         << endl;
+
+    return ntrials;
+}
+
+
 int Model :: set_eta_and_chi ()
 {
     Solver solver;
@@ -34,6 +34,7 @@ struct Model
     }
 
     void read  (const Io& io);
+    void read  (const Io& io, const bool lazy);
     void write (const Io& io) const;
 
     void read  ()       {read  (IoPython ("hdf5", parameters.model_name()));};
@@ -47,16 +48,32 @@ struct Model
         const long double nu_min,
         const long double nu_max );
     int compute_LTE_level_populations             ();
+    int compute_LVG_level_populations             ();
+    int compute_level_populations_from_model      (
+        const Model &source,
+        const Size   n_nearest          );
     int compute_radiation_field                   ();
     int compute_radiation_field_feautrier_order_2 ();
+    int compute_radiation_field_feautrier_order_4 ();
     int compute_radiation_field_shortchar_order_0 ();
+    int compute_adaptive_rays                     ();
     int compute_Jeff                              ();
     int compute_level_populations_from_stateq     ();
     int compute_level_populations                 (
         // const Io   &io,
         const bool  use_Ng_acceleration,
         const long  max_niterations     );
+    int compute_level_populations_gauss_seidel    (
+        const long  max_niterations     );
+    int compute_level_populations_incremental     (
+        const Size1 &modified,
+        const long   max_niterations    );
     int compute_image                             (const Size ray_nr);
+    int compute_image_shortchar_order_1           (const Size ray_nr);
+    int tune_solver_parameters                    (
+        const double tolerance,
+        const long   max_niterations,
+        const Size   subsample = 1      );
 
     Double1 error_max;
     Double1 error_mean;
@@ -40,7 +40,10 @@
         inline void set_##x (const type value)   /* Setter function                    */   \
         {                                                                                   \
             x##__.set (value);                   /* Set local value                    */   \
-            x() = value;                         /* Set global value                   */   \
+            if (x() != value)                    /* Only write global if it changes,   */   \
+            {                                    /* such that setting it again to the  */   \
+                x() = value;                     /* same value (e.g. concurrently in   */   \
+            }                                    /* Model::read) only reads it         */   \
         }                                                                                   \
         inline type get_##x () const             /* Getter function                    */   \
         {                                                                                   \
@@ -130,8 +133,23 @@ struct Parameters
 
     long n_off_diag = 0;
 
+    double lambda_threshold   = 0.0;   ///< magnitude (relative to the diagonal) below which off-diagonal ALO contributions are dropped
+    long   lambda_max_entries = 0;     ///< maximum number of ALO elements per point and transition (0 = no limit)
+
     double max_width_fraction = 0.5;
 
+    double tau_max = 0.0;   ///< optical depth at which rays are truncated (0 = trace to the boundary)
+
+    double ray_tolerance = 1.0e-2;   ///< relative change in u above which adaptive rays are refined
+
+    long n_sweep_blocks = 64;   ///< number of blocks in a Gauss-Seidel sweep (more is closer to point-wise)
+
+    bool store_intensities     = true;    ///< store radiation.I in the short-characteristics solver
+    bool first_stage_shortchar = false;   ///< start the level population iterations with short characteristics
+
+    long tuned_nquads = 0;   ///< number of quadrature points proposed by the tuner (0 = not tuned)
+    long tuned_nrays  = 0;   ///< number of rays              proposed by the tuner (0 = not tuned)
+
     void read (const Io &io);
     void write(const Io &io) const;
 
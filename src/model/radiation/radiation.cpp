@@ -16,6 +16,10 @@ void Radiation :: read (const Io& io)
 
     frequencies.read (io);
 
+    // Flat indices over points and frequencies need to fit in an Index
+    // (the tensors over rays, points and frequencies are indexed by Paracabs)
+    check_index_range ("the radiation field", parameters.npoints(), parameters.nfreqs());
+
     if (parameters.use_scattering())
     {
         cout << "Using scattering, make sure you have enough memory!" << endl;
@@ -32,17 +36,7 @@ void Radiation :: read (const Io& io)
 
     // Size and initialize I_bdy, u, v, U and V
 
-    I_bdy.resize (parameters.nrays_red());
-
-    for (Size r = 0; r < parameters.nrays_red(); r++)
-    {
-        I_bdy[r].resize (parameters.nboundary());
-
-        for (Size p = 0; p < parameters.nboundary(); p++)
-        {
-            I_bdy[r][p].resize (parameters.nfreqs());
-        }
-    }
+    I_bdy.resize (parameters.nrays_red(), parameters.nboundary(), parameters.nfreqs());
 
 
     I.resize (parameters.nrays(),  parameters.npoints(), parameters.nfreqs());
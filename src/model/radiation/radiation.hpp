@@ -28,13 +28,13 @@ struct Radiation
     // vector<Matrix<Real>> V;         ///< V scattered intensity   (r, index(p,f))
 
     // Real1 J;         ///< (angular) mean intensity (index(p,f))
-    Real3 I_bdy;     ///< intensity at the boundary (r,b,f)
+    Tensor<Real> I_bdy;     ///< intensity at the boundary (r,b,f)
 
     void read  (const Io& io);
     void write (const Io& io) const;
 
-    inline Size index (const Size p, const Size f) const;
-    inline Size index (const Size p, const Size f, const Size m) const;
+    inline Index index (const Size p, const Size f) const;
+    inline Index index (const Size p, const Size f, const Size m) const;
 
     inline Real get_U (const Size R, const Size p, const Size f) const;
     inline Real get_V (const Size R, const Size p, const Size f) const;
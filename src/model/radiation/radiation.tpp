@@ -1,9 +1,9 @@
 #include "tools/interpolation.hpp"
 
 
-inline Size Radiation :: index (const Size p, const Size f ) const
+inline Index Radiation :: index (const Size p, const Size f ) const
 {
-    return f + p * parameters.nfreqs();
+    return f + ((Index) p) * parameters.nfreqs();
 }
 
 
@@ -21,7 +21,7 @@ inline Size Radiation :: index (const Size p, const Size f ) const
 
 inline Real Radiation :: get_I_bdy (const Size R, const Size b, const Size f) const
 {
-    return I_bdy[R][b][f];
+    return I_bdy(R,b,f);
 }
 
 
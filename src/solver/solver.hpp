@@ -3,46 +3,89 @@
 
 #include "model/model.hpp"
 #include "tools/types.hpp"
+#include "tools/perf_counters.hpp"
 
+#include <unordered_map>
 
-class Solver
+
+///  Scratch memory of a single thread, used while solving along a ray pair.
+///  The struct is aligned to a cache line, and starts with a padding line, such
+///  that the scratch of different threads never shares a cache line (also when
+///  the allocator does not honour the alignment, as before C++17).
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(64) Scratch
 {
-    public:
-        pc::multi_threading::ThreadPrivate<Vector<double>> dZ_;      ///< distance increments along the ray
-        pc::multi_threading::ThreadPrivate<Vector<Size>>   nr_;      ///< corresponding point number on the ray
-        pc::multi_threading::ThreadPrivate<Vector<double>> shift_;   ///< Doppler shift along the ray
+    char padding[64];
+
+    Vector<double> dZ;      ///< distance increments along the ray
+    Vector<Size>   nr;      ///< corresponding point number on the ray
+    Vector<double> shift;   ///< Doppler shift along the ray
+
+    Vector<Real> eta_c;
+    Vector<Real> eta_n;
+
+    Vector<Real> chi_c;
+    Vector<Real> chi_n;
+
+    Vector<Real> inverse_chi;
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> eta_c_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> eta_n_;
+    Vector<Real> tau;
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> chi_c_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> chi_n_;
+    Vector<Real> I_rr;      ///< intensity along the ray          (short characteristics)
+    Vector<Real> I_ar;      ///< intensity along the antipodal ray (short characteristics)
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> inverse_chi_;
+    Vector<Real> eta_ray;   ///< emissivities cached along a truncated ray
+    Vector<Real> chi_ray;   ///< opacities    cached along a truncated ray
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> tau_;
+    Size first;             ///< index of the first point on the ray
+    Size last;              ///< index of the last  point on the ray
+    Size n_tot;             ///< number of points on the ray
+
+    Vector<Real> Su;
+    Vector<Real> Sv;
+
+    Vector<Real> A;
+    Vector<Real> C;
+    Vector<Real> inverse_A;
+    Vector<Real> inverse_C;
+
+    Vector<Real> FF;
+    Vector<Real> FI;
+    Vector<Real> GG;
+    Vector<Real> GI;
+    Vector<Real> GP;
+
+    Vector<Real> Ra;        ///< weight of S[n-1] in the right-hand side (4th-order Feautrier)
+    Vector<Real> Rb;        ///< weight of S[n  ] in the right-hand side (4th-order Feautrier)
+    Vector<Real> Rc;        ///< weight of S[n+1] in the right-hand side (4th-order Feautrier)
+
+    Vector<Real> L_diag;
+    Matrix<Real> L_upper;
+    Matrix<Real> L_lower;
+
+    inline void resize (const Size length, const Size width, const Size n_off_diag);
+};
 
-        pc::multi_threading::ThreadPrivate<Size> first_;
-        pc::multi_threading::ThreadPrivate<Size> last_;
-        pc::multi_threading::ThreadPrivate<Size> n_tot_;
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> Su_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> Sv_;
+///  Path of a ray pair through an origin, as traced in the scratch memory. Only
+///  the entries from first to last are stored, i.e. 4+8+8 bytes per point on the
+///  ray pair (plus a constant overhead of about 100 bytes per path).
+/////////////////////////////////////////////////////////////////////////////////
+struct RayPairPath
+{
+    Size first;        ///< index of the first point on the ray
+    Size last;         ///< index of the last  point on the ray
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> A_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> C_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> inverse_A_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> inverse_C_;
+    Size1   nr;        ///< point numbers        from first to last
+    Double1 dZ;        ///< distance increments  from first to last
+    Double1 shift;     ///< Doppler shifts       from first to last
+};
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> FF_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> FI_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> GG_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> GI_;
-        pc::multi_threading::ThreadPrivate<Vector<Real>> GP_;
 
-        pc::multi_threading::ThreadPrivate<Vector<Real>> L_diag_;
-        pc::multi_threading::ThreadPrivate<Matrix<Real>> L_upper_;
-        pc::multi_threading::ThreadPrivate<Matrix<Real>> L_lower_;
+class Solver
+{
+    public:
+        pc::multi_threading::ThreadPrivate<Scratch> scratch_;   ///< scratch memory per thread
 
 
         // Kernel approach
@@ -79,11 +122,21 @@ class Solver
 
         Size n_off_diag;
 
+        Real lambda_threshold   = 0.0;   ///< relative magnitude below which off-diagonal ALO contributions are dropped
+        Size lambda_max_entries = 0;     ///< maximum number of ALO elements per point and transition (0 = no limit)
+
+        bool full_lambda = false;   ///< compute the complete L_upper/L_lower along each ray (not only the centre row)
+        bool keep_lambda = false;   ///< do not add to Lambda (used when re-solving only some ray pairs)
+
+        bool cache_paths = false;   ///< cache the paths of the ray pairs re-solved for changed points
+        vector<std::unordered_map<Size, RayPairPath>> path_cache;   ///< cached paths, per ray and origin
+
 
         // void initialize (const Size l, const Size w);
 
         template <Frame frame>
         accel inline Size trace_ray (
+                  Scratch&  scratch,
             const Geometry& geometry,
             const Size      o,
             const Size      r,
@@ -92,16 +145,25 @@ class Solver
                   Size      id1,
                   Size      id2 );
 
+        accel inline void truncate_ray (
+            const Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     f,
+            const Size     first_ray,
+            const Size     last_ray  );
+
         accel inline void set_data (
-            const Size   crt,
-            const Size   nxt,
-            const double shift_crt,
-            const double shift_nxt,
-            const double dZ_loc,
-            const double dshift_max,
-            const int    increment,
-                  Size&  id1,
-                  Size&  id2 );
+                  Scratch& scratch,
+            const Size     crt,
+            const Size     nxt,
+            const double   shift_crt,
+            const double   shift_nxt,
+            const double   dZ_loc,
+            const double   dshift_max,
+            const int      increment,
+                  Size&    id1,
+                  Size&    id2 );
 
         accel inline Real gaussian (const Real width, const Real diff) const;
         accel inline Real planck   (const Real temp,  const Real freq) const;
@@ -119,33 +181,83 @@ class Solver
                   Real&  chi ) const;
 
         accel inline void update_Lambda (
-                  Model &model,
-            const Size   rr,
-            const Size   f  );
+                  Model   &model,
+            const Scratch &scratch,
+            const Size     rr,
+            const Size     f  );
 
 
         accel inline void solve_shortchar_order_0 (Model& model);
         accel inline void solve_shortchar_order_0 (
-                  Model& model,
-            const Size   o,
-            const Size   r,
-            const double dshift_max );
+                  Model&        model,
+                  Scratch&      scratch,
+            const Size          o,
+            const Size          r,
+                  Vector<Real>& I );
 
         accel inline void solve_feautrier_order_2 (Model& model);
+        accel inline void solve_feautrier_order_2 (Model& model, const Vector<Size>& origins);
+        accel inline void solve_feautrier_order_2 (Model& model, const Char1& changed, Size1& n_pairs);
         accel inline void solve_feautrier_order_2 (
-                  Model& model,
-            const Size   o,
-            const Size   rr,
-            const Size   ar,
-            const Size   f  );
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar );
+        accel inline void solve_feautrier_order_2_traced (
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar );
+        accel inline void trace_ray_pair (
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar );
+        inline void store_ray_pair   (const Scratch& scratch, RayPairPath& path) const;
+        inline void restore_ray_pair (Scratch& scratch, const RayPairPath& path) const;
+        accel inline void solve_feautrier_order_2 (
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar,
+            const Size     f  );
+
+        inline void set_adaptive_rays (Model& model);
+
+        accel inline void solve_feautrier_order_4 (Model& model);
+        accel inline void solve_feautrier_order_4 (
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar );
+        accel inline void solve_feautrier_order_4 (
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar,
+            const Size     f  );
 
         accel inline void image_feautrier_order_2 (Model& model, const Size rr);
         accel inline void image_feautrier_order_2 (
-                  Model& model,
-            const Size   o,
-            const Size   rr,
-            const Size   ar,
-            const Size   f  );
+                  Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+            const Size     rr,
+            const Size     ar,
+            const Size     f  );
+
+        accel inline void image_shortchar_order_1 (Model& model, const Size rr);
+        accel inline void image_shortchar_order_1 (
+            const Model&   model,
+                  Scratch& scratch,
+            const Size     o,
+                  Image&   image );
 
 
         accel inline Real     kernel (const Vector3D d) const;
@@ -6,50 +6,74 @@ inline void Solver :: setup (Model& model)
     const Size  n_o_d = model.parameters.n_off_diag;
 
     setup (length, width, n_o_d);
+
+    lambda_threshold   = model.parameters.lambda_threshold;
+    lambda_max_entries = model.parameters.lambda_max_entries;
 }
 
 
-inline void Solver :: setup (const Size l, const Size w, const Size n_o_d)
+///  Resize the scratch memory of a thread
+///    @param[in] length     : maximum number of points on a ray pair
+///    @param[in] width      : number of frequencies
+///    @param[in] n_off_diag : number of off-diagonals in the ALO
+///////////////////////////////////////////////////////////////////
+inline void Scratch :: resize (const Size length, const Size width, const Size n_off_diag)
 {
-    length     = l;
-    centre     = l/2;
-    width      = w;
-    n_off_diag = n_o_d;
+    dZ         .resize (length);
+    nr         .resize (length);
+    shift      .resize (length);
 
-    for (Size i = 0; i < pc::multi_threading::n_threads_avail(); i++)
-    {
-        dZ_          (i).resize (length);
-        nr_          (i).resize (length);
-        shift_       (i).resize (length);
+    eta_c      .resize (width);
+    eta_n      .resize (width);
+
+    chi_c      .resize (width);
+    chi_n      .resize (width);
+
+    inverse_chi.resize (length);
+
+    tau        .resize (width);
+
+    I_rr       .resize (width);
+    I_ar       .resize (width);
 
-        eta_c_       (i).resize (width);
-        eta_n_       (i).resize (width);
+    eta_ray    .resize (length);
+    chi_ray    .resize (length);
 
-        chi_c_       (i).resize (width);
-        chi_n_       (i).resize (width);
+    Su         .resize (length);
+    Sv         .resize (length);
 
-        inverse_chi_ (i).resize (length);
+    A          .resize (length);
+    C          .resize (length);
+    inverse_A  .resize (length);
+    inverse_C  .resize (length);
 
-        tau_         (i).resize (width);
+    FF         .resize (length);
+    FI         .resize (length);
+    GG         .resize (length);
+    GI         .resize (length);
+    GP         .resize (length);
 
-        Su_          (i).resize (length);
-        Sv_          (i).resize (length);
+    Ra         .resize (length);
+    Rb         .resize (length);
+    Rc         .resize (length);
 
-        A_           (i).resize (length);
-        C_           (i).resize (length);
-        inverse_A_   (i).resize (length);
-        inverse_C_   (i).resize (length);
+    L_diag     .resize (length);
+
+    L_upper    .resize (n_off_diag, length);
+    L_lower    .resize (n_off_diag, length);
+}
 
-        FF_          (i).resize (length);
-        FI_          (i).resize (length);
-        GG_          (i).resize (length);
-        GI_          (i).resize (length);
-        GP_          (i).resize (length);
 
-        L_diag_      (i).resize (length);
+inline void Solver :: setup (const Size l, const Size w, const Size n_o_d)
+{
+    length     = l;
+    centre     = l/2;
+    width      = w;
+    n_off_diag = n_o_d;
 
-        L_upper_     (i).resize (n_off_diag, length);
-        L_lower_     (i).resize (n_off_diag, length);
+    for (Size i = 0; i < pc::multi_threading::n_threads_avail(); i++)
+    {
+        scratch_(i).resize (length, width, n_off_diag);
     }
 }
 
@@ -89,6 +113,8 @@ inline void Solver :: get_ray_lengths (Model& model)
 
         accelerated_for (o, model.parameters.npoints(),
         {
+            PERF_SCOPE (PERF_TRACE_RAY);
+
             const Real dshift_max = get_dshift_max (model, o);
 
             model.geometry.lengths(rr,o) =
@@ -142,12 +168,19 @@ inline Size Solver :: get_ray_lengths_max (Model& model)
 // }
 
 
+///  Solver for the radiation field (I, u, v, J and the diagonal of Lambda) using
+///  short characteristics from each origin towards the boundary, assuming the
+///  source function is linear between consecutive points. Storing I is optional
+///  (see Parameters::store_intensities), since u and v follow directly.
+//////////////////////////////////////////////////////////////////////////////////
 inline void Solver :: solve_shortchar_order_0 (Model& model)
 {
     for (auto &lspec : model.lines.lineProducingSpecies) {lspec.lambda.clear();}
 
     model.radiation.initialize_J();
 
+    const bool store_intensities = model.parameters.store_intensities;
+
     for (Size rr = 0; rr < model.parameters.hnrays(); rr++)
     {
         const Size ar = model.geometry.rays.antipod[rr];
@@ -156,24 +189,41 @@ inline void Solver :: solve_shortchar_order_0 (Model& model)
 
         accelerated_for (o, model.parameters.npoints(),
         {
-            // const Real dshift_max = get_dshift_max (o);
-            const Real dshift_max = 1.0e+99;
+            if (model.geometry.rays.get_weight (o, rr) > 0.0)
+            {
+                Scratch& scratch = scratch_();
 
-            solve_shortchar_order_0 (model, o, rr, dshift_max);
-            solve_shortchar_order_0 (model, o, ar, dshift_max);
+                solve_shortchar_order_0 (model, scratch, o, rr, scratch.I_rr);
+                solve_shortchar_order_0 (model, scratch, o, ar, scratch.I_ar);
 
-            for (Size f = 0; f < model.parameters.nfreqs(); f++)
-            {
-                model.radiation.u(rr,o,f) = 0.5 * (model.radiation.I(rr,o,f) + model.radiation.I(ar,o,f));
-                model.radiation.v(rr,o,f) = 0.5 * (model.radiation.I(rr,o,f) - model.radiation.I(ar,o,f));
+                for (Size f = 0; f < model.parameters.nfreqs(); f++)
+                {
+                    model.radiation.u(rr,o,f) = half * (scratch.I_rr[f] + scratch.I_ar[f]);
+                    model.radiation.v(rr,o,f) = half * (scratch.I_rr[f] - scratch.I_ar[f]);
+                }
+
+                if (store_intensities)
+                {
+                    for (Size f = 0; f < model.parameters.nfreqs(); f++)
+                    {
+                        model.radiation.I(rr,o,f) = scratch.I_rr[f];
+                        model.radiation.I(ar,o,f) = scratch.I_ar[f];
+                    }
+                }
             }
         })
 
         pc::accelerator::synchronize();
     }
 
-    model.radiation.I.copy_ptr_to_vec();
+    model.radiation.u.copy_ptr_to_vec();
+    model.radiation.v.copy_ptr_to_vec();
     model.radiation.J.copy_ptr_to_vec();
+
+    if (store_intensities)
+    {
+        model.radiation.I.copy_ptr_to_vec();
+    }
 }
 
 
@@ -191,45 +241,499 @@ inline void Solver :: solve_feautrier_order_2 (Model& model)
 
         accelerated_for (o, model.parameters.npoints(),
         {
-            const Real dshift_max = get_dshift_max (model, o);
+            if (model.geometry.rays.get_weight (o, rr) > 0.0)
+            {
+                solve_feautrier_order_2 (model, scratch_(), o, rr, ar);
+            }
+        })
+
+        pc::accelerator::synchronize();
+    }
+
+    if (lambda_threshold > 0.0)
+    {
+        for (auto &lspec : model.lines.lineProducingSpecies) {lspec.lambda.prune (lambda_threshold);}
+    }
 
-            nr_   ()[centre] = o;
-            shift_()[centre] = 1.0;
+    model.radiation.u.copy_ptr_to_vec();
+    model.radiation.J.copy_ptr_to_vec();
+}
+
+
+///  Solver for the radiation field (J, u and Lambda) in the given origins only,
+///  leaving the other points untouched (used in Gauss-Seidel iterations)
+///    @param[in] origins : indices of the points in which to solve
+////////////////////////////////////////////////////////////////////////////////
+inline void Solver :: solve_feautrier_order_2 (Model& model, const Vector<Size>& origins)
+{
+    threaded_for (i, origins.size(),
+    {
+        const Size o = origins[i];
+
+        for (auto &lspec : model.lines.lineProducingSpecies) {lspec.lambda.clear (o);}
+
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            model.radiation.J(o,f) = 0.0;
+        }
+    })
 
-            first_() = trace_ray <CoMoving> (model.geometry, o, rr, dshift_max, -1, centre-1, centre-1) + 1;
-            last_ () = trace_ray <CoMoving> (model.geometry, o, ar, dshift_max, +1, centre+1, centre  ) - 1;
-            n_tot_() = (last_()+1) - first_();
+    for (Size rr = 0; rr < model.parameters.hnrays(); rr++)
+    {
+        const Size ar = model.geometry.rays.antipod[rr];
 
-            if (n_tot_() > 1)
+        accelerated_for (i, origins.size(),
+        {
+            if (model.geometry.rays.get_weight (origins[i], rr) > 0.0)
             {
-                for (Size f = 0; f < model.parameters.nfreqs(); f++)
+                solve_feautrier_order_2 (model, scratch_(), origins[i], rr, ar);
+            }
+        })
+
+        pc::accelerator::synchronize();
+    }
+
+    model.radiation.u.copy_ptr_to_vec();
+    model.radiation.J.copy_ptr_to_vec();
+}
+
+
+///  Solver for the radiation field (J and u) along only those ray pairs that pass
+///  through a changed point, replacing their previous contribution to J. Lambda
+///  is kept as it is, since it only serves to accelerate the iterations. Ray pairs
+///  are traced (using the successor graph if it is set) unless their path is in
+///  the path cache. With cache_paths set, the paths of the re-solved ray pairs
+///  are added to the cache, such that, by setting it only in the first call, the
+///  cache holds the ray pairs through the modified region (see RayPairPath for
+///  its memory cost), rather than all npoints x hnrays paths.
+///    @param[in]  changed : (non-zero) for the points of which the emissivity,
+///                          opacity or velocity changed
+///    @param[out] n_pairs : number of re-solved ray pairs in each origin
+////////////////////////////////////////////////////////////////////////////////////
+inline void Solver :: solve_feautrier_order_2 (Model& model, const Char1& changed, Size1& n_pairs)
+{
+    n_pairs.assign (model.parameters.npoints(), 0);
+
+    path_cache.resize (model.parameters.hnrays());
+
+    keep_lambda = true;
+
+    for (Size rr = 0; rr < model.parameters.hnrays(); rr++)
+    {
+        const Size ar = model.geometry.rays.antipod[rr];
+
+        // Paths to add to the cache (only filled with cache_paths)
+        vector<RayPairPath> new_paths (cache_paths ? model.parameters.npoints() : 0);
+
+        const std::unordered_map<Size, RayPairPath>& cache_rr = path_cache[rr];
+
+        threaded_for (o, model.parameters.npoints(),
+        {
+            const Real w_ang = two * model.geometry.rays.get_weight (o, rr);
+
+            if (w_ang > 0.0)
+            {
+                Scratch& scratch = scratch_();
+
+                const auto cached = cache_rr.find (o);
+
+                if (cached != cache_rr.end()) {restore_ray_pair (scratch, cached->second);}
+                else                          {trace_ray_pair   (model, scratch, o, rr, ar);}
+
+                bool affected = false;
+
+                for (Size n = scratch.first; (n <= scratch.last) && !affected; n++)
                 {
-                    solve_feautrier_order_2 (model, o, rr, ar, f);
+                    affected = changed[scratch.nr[n]];
+                }
 
-                    model.radiation.u(rr,o,f)  = Su_()[centre];
-                    model.radiation.J(   o,f) += Su_()[centre] * two * model.geometry.rays.weight[rr];
+                if (affected)
+                {
+                    if (cache_paths && (cached == cache_rr.end()))
+                    {
+                        store_ray_pair (scratch, new_paths[o]);
+                    }
+
+                    for (Size f = 0; f < model.parameters.nfreqs(); f++)
+                    {
+                        model.radiation.J(o,f) -= w_ang * model.radiation.u(rr,o,f);
+                    }
+
+                    solve_feautrier_order_2_traced (model, scratch, o, rr, ar);
 
-                    update_Lambda (model, rr, f);
+                    n_pairs[o]++;
                 }
             }
-            else
+        })
+
+        pc::accelerator::synchronize();
+
+        for (Size o = 0; o < new_paths.size(); o++)
+        {
+            if (new_paths[o].nr.size() > 0)
             {
-                for (Size f = 0; f < model.parameters.nfreqs(); f++)
+                path_cache[rr].emplace (o, std::move (new_paths[o]));
+            }
+        }
+    }
+
+    keep_lambda = false;
+
+    model.radiation.u.copy_ptr_to_vec();
+    model.radiation.J.copy_ptr_to_vec();
+}
+
+
+///  Copier of the ray pair path in the scratch memory to a cached path
+///    @param[in]  scratch : scratch memory with the traced ray pair
+///    @param[out] path    : path of the ray pair
+/////////////////////////////////////////////////////////////////////////
+inline void Solver :: store_ray_pair (const Scratch& scratch, RayPairPath& path) const
+{
+    path.first = scratch.first;
+    path.last  = scratch.last;
+
+    path.nr   .resize ((scratch.last+1) - scratch.first);
+    path.dZ   .resize ((scratch.last+1) - scratch.first);
+    path.shift.resize ((scratch.last+1) - scratch.first);
+
+    for (Size n = scratch.first; n <= scratch.last; n++)
+    {
+        path.nr   [n-scratch.first] = scratch.nr   [n];
+        path.dZ   [n-scratch.first] = scratch.dZ   [n];
+        path.shift[n-scratch.first] = scratch.shift[n];
+    }
+}
+
+
+///  Copier of a cached ray pair path into the scratch memory (replaces tracing)
+///    @param[out] scratch : scratch memory to hold the ray pair
+///    @param[in]  path    : path of the ray pair
+/////////////////////////////////////////////////////////////////////////////////
+inline void Solver :: restore_ray_pair (Scratch& scratch, const RayPairPath& path) const
+{
+    scratch.first = path.first;
+    scratch.last  = path.last;
+    scratch.n_tot = (path.last+1) - path.first;
+
+    for (Size n = path.first; n <= path.last; n++)
+    {
+        scratch.nr   [n] = path.nr   [n-path.first];
+        scratch.dZ   [n] = path.dZ   [n-path.first];
+        scratch.shift[n] = path.shift[n-path.first];
+    }
+}
+
+
+///  Solver for the radiation field along the ray pair (rr, ar) through origin o,
+///  adding its contribution to J and Lambda for all frequencies
+///    @param[in] scratch : scratch memory of the calling thread
+///    @param[in] o       : index of the origin
+///    @param[in] rr      : index of the ray
+///    @param[in] ar      : index of the antipodal ray
+/////////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: solve_feautrier_order_2 (
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar )
+{
+    trace_ray_pair                 (model, scratch, o, rr, ar);
+    solve_feautrier_order_2_traced (model, scratch, o, rr, ar);
+}
+
+
+///  Tracer for the ray pair (rr, ar) through origin o, setting the points, the
+///  distance increments and the Doppler shifts along it in the scratch memory
+///    @param[in] scratch : scratch memory of the calling thread
+///    @param[in] o       : index of the origin
+///    @param[in] rr      : index of the ray
+///    @param[in] ar      : index of the antipodal ray
+/////////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: trace_ray_pair (
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar )
+{
+    PERF_SCOPE (PERF_TRACE_RAY);
+
+    const Real dshift_max = get_dshift_max (model, o);
+
+    scratch.nr   [centre] = o;
+    scratch.shift[centre] = 1.0;
+
+    scratch.first = trace_ray <CoMoving> (scratch, model.geometry, o, rr, dshift_max, -1, centre-1, centre-1) + 1;
+    scratch.last  = trace_ray <CoMoving> (scratch, model.geometry, o, ar, dshift_max, +1, centre+1, centre  ) - 1;
+    scratch.n_tot = (scratch.last+1) - scratch.first;
+}
+
+
+///  Solver for the radiation field along the ray pair (rr, ar) through origin o,
+///  as traced (by trace_ray_pair) in the scratch memory, adding its contribution
+///  to J and Lambda for all frequencies
+///    @param[in] scratch : scratch memory of the calling thread (with the ray pair)
+///    @param[in] o       : index of the origin
+///    @param[in] rr      : index of the ray
+///    @param[in] ar      : index of the antipodal ray
+/////////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: solve_feautrier_order_2_traced (
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar )
+{
+    const Real w_ang = two * model.geometry.rays.get_weight (o, rr);
+
+    if (scratch.n_tot > 1)
+    {
+        PERF_SCOPE (PERF_FEAUTRIER);
+
+        const Size first_ray = scratch.first;
+        const Size last_ray  = scratch.last;
+
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            if (model.parameters.tau_max > 0.0)
+            {
+                truncate_ray (model, scratch, o, f, first_ray, last_ray);
+            }
+
+            solve_feautrier_order_2 (model, scratch, o, rr, ar, f);
+
+            model.radiation.u(rr,o,f)  = scratch.Su[centre];
+            model.radiation.J(   o,f) += scratch.Su[centre] * w_ang;
+
+            if ((w_ang > 0.0) && !keep_lambda)
+            {
+                update_Lambda (model, scratch, rr, f);
+            }
+        }
+    }
+    else
+    {
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            model.radiation.u(rr,o,f)  = boundary_intensity(model, o, model.radiation.frequencies.nu(o, f));
+            model.radiation.J(   o,f) += w_ang * model.radiation.u(rr,o,f);
+        }
+    }
+}
+
+
+///  Setter for the rays to trace in each point with adaptive ray tracing. In
+///  each point, the HEALPix pixels of order_min are split in their four children
+///  as long as u along the ray of the pixel differs (relatively, at any frequency)
+///  more than parameters.ray_tolerance from the mean u along its children, up to
+///  order_max. A selected pixel is traced along the ray closest to its centre,
+///  with the solid angle of the pixel as weight, in J as well as in Lambda.
+///  Antipodal pixels are selected together, since they share a ray pair.
+//////////////////////////////////////////////////////////////////////////////////
+inline void Solver :: set_adaptive_rays (Model& model)
+{
+    Rays& rays = model.geometry.rays;
+
+    rays.set_nested_rays ();
+
+    const Size order_min = model.parameters.order_min();
+    const Size order_max = model.parameters.order_max();
+
+    if ((order_min > order_max) || (order_max > rays.order))
+    {
+        throw std::runtime_error ("Adaptive rays require order_min <= order_max <= HEALPix order of the rays!");
+    }
+
+    const Size hnrays = model.parameters.hnrays();
+    const Real tol    = model.parameters.ray_tolerance;
+
+    // As long as the weights are zero, the solver only computes u (no J or Lambda)
+    rays.adaptive = true;
+    rays.point_weight.resize (hnrays, model.parameters.npoints());
+
+    threaded_for (o, model.parameters.npoints(),
+    {
+        Scratch& scratch = scratch_();
+
+        for (Size rr = 0; rr < hnrays; rr++)
+        {
+            rays.point_weight(rr,o) = 0.0;
+        }
+
+        Size1 pixels;     // ray pairs of the candidate pixels of the current order
+        Size1 children;   // ray pairs of the candidate pixels of the next    order
+
+        for (const Size r : rays.nested_ray[order_min])
+        {
+            if (r < hnrays)
+            {
+                solve_feautrier_order_2 (model, scratch, o, r, rays.antipod[r]);
+
+                pixels.push_back (r);
+            }
+        }
+
+        for (Size l = order_min; l <= order_max; l++)
+        {
+            const Size shift = 2*(rays.order-l);
+
+            children.clear();
+
+            for (const Size rr : pixels)
+            {
+                bool refine = false;
+
+                if (l < order_max)
+                {
+                    const Size q = rays.nested_pixel[rr] >> shift;
+
+                    Size cr[4];
+
+                    for (Size c = 0; c < 4; c++)
+                    {
+                        const Size r = rays.nested_ray[l+1][4*q+c];
+
+                        cr[c] = (r < hnrays) ? r : rays.antipod[r];
+
+                        solve_feautrier_order_2 (model, scratch, o, cr[c], rays.antipod[cr[c]]);
+                    }
+
+                    for (Size f = 0; (f < model.parameters.nfreqs()) && !refine; f++)
+                    {
+                        const Real u_mean = 0.25 * (  model.radiation.u(cr[0],o,f)
+                                                    + model.radiation.u(cr[1],o,f)
+                                                    + model.radiation.u(cr[2],o,f)
+                                                    + model.radiation.u(cr[3],o,f) );
+
+                        refine = (fabs (model.radiation.u(rr,o,f) - u_mean) > tol * fabs (u_mean));
+                    }
+
+                    if (refine)
+                    {
+                        children.insert (children.end(), cr, cr+4);
+                    }
+                }
+
+                if (!refine)
                 {
-                    model.radiation.u(rr,o,f)  = boundary_intensity(model, o, model.radiation.frequencies.nu(o, f));
-                    model.radiation.J(   o,f) += two * model.geometry.rays.weight[rr] * model.radiation.u(rr,o,f);
+                    rays.point_weight(rr,o) = rays.weight[rr] * (Size(1) << shift);
                 }
             }
+
+            pixels.swap (children);
+        }
+    })
+
+    rays.point_weight.copy_ptr_to_vec();
+
+    Size n_traced = 0;
+
+    for (Size i = 0; i < rays.point_weight.vec.size(); i++)
+    {
+        if (rays.point_weight.vec[i] > 0.0) {n_traced++;}
+    }
+
+    cout << "Adaptive rays: tracing " << n_traced << " of " << rays.point_weight.vec.size() << " ray pairs" << endl;
+}
+
+
+///  Solver for the radiation field (J, u and Lambda) using the Hermitian
+///  4th-order Feautrier scheme, which reaches the accuracy of the 2nd-order
+///  scheme on considerably coarser meshes in the optically thick regions.
+/////////////////////////////////////////////////////////////////////////////
+inline void Solver :: solve_feautrier_order_4 (Model& model)
+{
+    for (auto &lspec : model.lines.lineProducingSpecies) {lspec.lambda.clear();}
+
+    model.radiation.initialize_J();
+
+    for (Size rr = 0; rr < model.parameters.hnrays(); rr++)
+    {
+        const Size ar = model.geometry.rays.antipod[rr];
+
+        cout << "--- rr = " << rr << endl;
+
+        accelerated_for (o, model.parameters.npoints(),
+        {
+            if (model.geometry.rays.get_weight (o, rr) > 0.0)
+            {
+                solve_feautrier_order_4 (model, scratch_(), o, rr, ar);
+            }
         })
 
         pc::accelerator::synchronize();
     }
 
+    if (lambda_threshold > 0.0)
+    {
+        for (auto &lspec : model.lines.lineProducingSpecies) {lspec.lambda.prune (lambda_threshold);}
+    }
+
     model.radiation.u.copy_ptr_to_vec();
     model.radiation.J.copy_ptr_to_vec();
 }
 
 
+///  Solver for the radiation field along the ray pair (rr, ar) through origin o,
+///  using the 4th-order Feautrier scheme for all frequencies
+///    @param[in] scratch : scratch memory of the calling thread
+///    @param[in] o       : index of the origin
+///    @param[in] rr      : index of the ray
+///    @param[in] ar      : index of the antipodal ray
+/////////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: solve_feautrier_order_4 (
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar )
+{
+    const Real dshift_max = get_dshift_max (model, o);
+    const Real w_ang      = two * model.geometry.rays.get_weight (o, rr);
+
+    scratch.nr   [centre] = o;
+    scratch.shift[centre] = 1.0;
+
+    scratch.first = trace_ray <CoMoving> (scratch, model.geometry, o, rr, dshift_max, -1, centre-1, centre-1) + 1;
+    scratch.last  = trace_ray <CoMoving> (scratch, model.geometry, o, ar, dshift_max, +1, centre+1, centre  ) - 1;
+    scratch.n_tot = (scratch.last+1) - scratch.first;
+
+    if (scratch.n_tot > 1)
+    {
+        const Size first_ray = scratch.first;
+        const Size last_ray  = scratch.last;
+
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            if (model.parameters.tau_max > 0.0)
+            {
+                truncate_ray (model, scratch, o, f, first_ray, last_ray);
+            }
+
+            solve_feautrier_order_4 (model, scratch, o, rr, ar, f);
+
+            model.radiation.u(rr,o,f)  = scratch.Su[centre];
+            model.radiation.J(   o,f) += scratch.Su[centre] * w_ang;
+
+            if ((w_ang > 0.0) && !keep_lambda)
+            {
+                update_Lambda (model, scratch, rr, f);
+            }
+        }
+    }
+    else
+    {
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            model.radiation.u(rr,o,f)  = boundary_intensity(model, o, model.radiation.frequencies.nu(o, f));
+            model.radiation.J(   o,f) += w_ang * model.radiation.u(rr,o,f);
+        }
+    }
+}
+
+
 inline void Solver :: image_feautrier_order_2 (Model& model, const Size rr)
 {
     Image image = Image(model.geometry, rr);
@@ -243,22 +747,68 @@ inline void Solver :: image_feautrier_order_2 (Model& model, const Size rr)
     {
         const Real dshift_max = get_dshift_max (model, o);
 
-        nr_   ()[centre] = o;
-        shift_()[centre] = 1.0;
+        Scratch& scratch = scratch_();
+
+        scratch.nr   [centre] = o;
+        scratch.shift[centre] = 1.0;
 
-        first_() = trace_ray <Rest> (model.geometry, o, rr, dshift_max, -1, centre-1, centre-1) + 1;
-        last_ () = trace_ray <Rest> (model.geometry, o, ar, dshift_max, +1, centre+1, centre  ) - 1;
-        n_tot_() = (last_()+1) - first_();
+        scratch.first = trace_ray <Rest> (scratch, model.geometry, o, rr, dshift_max, -1, centre-1, centre-1) + 1;
+        scratch.last  = trace_ray <Rest> (scratch, model.geometry, o, ar, dshift_max, +1, centre+1, centre  ) - 1;
+        scratch.n_tot = (scratch.last+1) - scratch.first;
 
-        if (n_tot_() > 1)
+        if (scratch.n_tot > 1)
         {
             for (Size f = 0; f < model.parameters.nfreqs(); f++)
             {
-                image_feautrier_order_2 (model, o, rr, ar, f);
+                image_feautrier_order_2 (model, scratch, o, rr, ar, f);
 
-                image.I(o,f) = two*Su_()[first_()] - boundary_intensity(model, nr_()[first_()], model.radiation.frequencies.nu(o, f));
+                image.I(o,f) = two*scratch.Su[scratch.first] - boundary_intensity(model, scratch.nr[scratch.first], model.radiation.frequencies.nu(o, f));
+            }
+        }
+        else
+        {
+            for (Size f = 0; f < model.parameters.nfreqs(); f++)
+            {
+                image.I(o,f) = boundary_intensity(model, o, model.radiation.frequencies.nu(o, f));
             }
         }
+    })
+
+    pc::accelerator::synchronize();
+
+    model.images.push_back (image);
+}
+
+
+///  Image solver integrating the transfer equation along each ray, from the
+///  observer inwards, assuming a linear source function between consecutive
+///  points. This only yields the emergent intensity (no J, u or Lambda), and
+///  stops as soon as the remaining part of the ray is optically invisible.
+///    @param[in] rr : index of the ray along which the image is taken
+/////////////////////////////////////////////////////////////////////////////////
+inline void Solver :: image_shortchar_order_1 (Model& model, const Size rr)
+{
+    Image image = Image(model.geometry, rr);
+
+    const Size ar = model.geometry.rays.antipod[rr];
+
+    accelerated_for (o, model.parameters.npoints(),
+    {
+        const Real dshift_max = get_dshift_max (model, o);
+
+        Scratch& scratch = scratch_();
+
+        scratch.nr   [centre] = o;
+        scratch.shift[centre] = 1.0;
+
+        scratch.first = trace_ray <Rest> (scratch, model.geometry, o, rr, dshift_max, -1, centre-1, centre-1) + 1;
+        scratch.last  = trace_ray <Rest> (scratch, model.geometry, o, ar, dshift_max, +1, centre+1, centre  ) - 1;
+        scratch.n_tot = (scratch.last+1) - scratch.first;
+
+        if (scratch.n_tot > 1)
+        {
+            image_shortchar_order_1 (model, scratch, o, image);
+        }
         else
         {
             for (Size f = 0; f < model.parameters.nfreqs(); f++)
@@ -274,8 +824,115 @@ inline void Solver :: image_feautrier_order_2 (Model& model, const Size rr)
 }
 
 
+///  Formal solution along the traced ray through origin o, from the observer
+///  (first point) inwards, with the frequency loop innermost. The emergent
+///  intensity is the sum of the contributions of all segments, attenuated by the
+///  optical depth in front of them. Frequencies for which this optical depth
+///  exceeds tau_cut are dropped (tau_max if set, else invisible to precision).
+///    @param[in]  scratch : scratch memory of the calling thread
+///    @param[in]  o       : index of the origin
+///    @param[out] image   : image in which to store the emergent intensity
+////////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: image_shortchar_order_1 (
+    const Model&   model,
+          Scratch& scratch,
+    const Size     o,
+          Image&   image )
+{
+    const Size first = scratch.first;
+    const Size last  = scratch.last;
+
+    const Real tau_cut = (model.parameters.tau_max > 0.0) ? model.parameters.tau_max : 50.0;
+
+    Vector<double>& dZ    = scratch.dZ;
+    Vector<Size  >& nr    = scratch.nr;
+    Vector<double>& shift = scratch.shift;
+
+    Vector<Real>& S_c   = scratch.eta_c;   // source function in the current point
+    Vector<Real>& chi_c = scratch.chi_c;   // opacity         in the current point
+    Vector<Real>& trans = scratch.eta_n;   // transmission (exp(-tau)) up to the current point
+    Vector<Real>& tau   = scratch.tau;     // optical depth   up to the current point
+
+    Real eta, chi_n;
+
+    // Start at the observer's end of the ray
+    for (Size f = 0; f < model.parameters.nfreqs(); f++)
+    {
+        const Real freq = model.radiation.frequencies.nu(o, f);
+
+        get_eta_and_chi (model, nr[first], freq*shift[first], eta, chi_c[f]);
+
+        S_c  [f] = eta / chi_c[f];
+        trans[f] = one;
+        tau  [f] = 0.0;
+
+        image.I(o,f) = 0.0;
+    }
+
+    Size n_active = model.parameters.nfreqs();
+
+    for (Size n = first; (n < last) && (n_active > 0); n++)
+    {
+        n_active = 0;
+
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            if (tau[f] > tau_cut) {continue;}
+
+            n_active++;
+
+            const Real freq = model.radiation.frequencies.nu(o, f);
+
+            get_eta_and_chi (model, nr[n+1], freq*shift[n+1], eta, chi_n);
+
+            const Real S_n = eta / chi_n;
+
+            const Real dtau         = half * (chi_c[f] + chi_n) * dZ[n];
+            const Real one_min_expt = -expm1 (-dtau);
+            const Real expt         = one - one_min_expt;
+
+            // Weights of the source function in the current (downstream) and
+            // next (upstream) point (series expansion for small dtau)
+            Real w_c, w_n;
+
+            if (dtau < 1.0e-3)
+            {
+                w_c = dtau * (half - dtau * (ONE_SIXTH - dtau / 24.0));
+                w_n = dtau * (half - dtau * (ONE_THIRD - 0.125 * dtau));
+            }
+            else
+            {
+                const Real one_min_expt_over_dtau = one_min_expt / dtau;
+
+                w_c = one - one_min_expt_over_dtau;
+                w_n = one_min_expt_over_dtau - expt;
+            }
+
+            image.I(o,f) += trans[f] * (w_c * S_c[f] + w_n * S_n);
+
+            trans[f] *= expt;
+            tau  [f] += dtau;
+            S_c  [f]  = S_n;
+            chi_c[f]  = chi_n;
+        }
+    }
+
+    // Add the attenuated boundary intensity where the ray was not cut
+    for (Size f = 0; f < model.parameters.nfreqs(); f++)
+    {
+        if (tau[f] <= tau_cut)
+        {
+            const Real freq = model.radiation.frequencies.nu(o, f);
+
+            image.I(o,f) += trans[f] * boundary_intensity (model, nr[last], freq*shift[last]);
+        }
+    }
+}
+
+
 template <Frame frame>
 accel inline Size Solver :: trace_ray (
+          Scratch&  scratch,
     const Geometry& geometry,
     const Size      o,
     const Size      r,
@@ -295,7 +952,7 @@ accel inline Size Solver :: trace_ray (
         double shift_crt = geometry.get_shift <frame> (o, r, crt, 0.0);
         double shift_nxt = geometry.get_shift <frame> (o, r, nxt, Z  );
 
-        set_data (crt, nxt, shift_crt, shift_nxt, dZ, dshift_max, increment, id1, id2);
+        set_data (scratch, crt, nxt, shift_crt, shift_nxt, dZ, dshift_max, increment, id1, id2);
 
         while (geometry.not_on_boundary(nxt))
         {
@@ -305,7 +962,7 @@ accel inline Size Solver :: trace_ray (
                   nxt = geometry.get_next          (o, r, nxt, Z, dZ);
             shift_nxt = geometry.get_shift <frame> (o, r, nxt, Z    );
 
-            set_data (crt, nxt, shift_crt, shift_nxt, dZ, dshift_max, increment, id1, id2);
+            set_data (scratch, crt, nxt, shift_crt, shift_nxt, dZ, dshift_max, increment, id1, id2);
         }
     }
 
@@ -313,20 +970,84 @@ accel inline Size Solver :: trace_ray (
 }
 
 
+///  Truncate the ray (for the given frequency) at the points where the
+///  optical depth, measured from the centre, exceeds tau_max. The opacities
+///  are those currently in the model (LTE or previous iteration). The
+///  emissivities and opacities along the truncated ray are cached for the
+///  Feautrier solver, such that points beyond the cut are never evaluated.
+///    @param[in] scratch   : scratch memory of the calling thread
+///    @param[in] o         : index of the origin of the ray
+///    @param[in] f         : index of the frequency bin
+///    @param[in] first_ray : index of the first point on the full ray
+///    @param[in] last_ray  : index of the last point on the full ray
+/////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: truncate_ray (
+    const Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     f,
+    const Size     first_ray,
+    const Size     last_ray  )
+{
+    const Real freq    = model.radiation.frequencies.nu(o, f);
+    const Real tau_max = model.parameters.tau_max;
+
+    Vector<double>& dZ      = scratch.dZ;
+    Vector<Size  >& nr      = scratch.nr;
+    Vector<double>& shift   = scratch.shift;
+    Vector<Real  >& eta_ray = scratch.eta_ray;
+    Vector<Real  >& chi_ray = scratch.chi_ray;
+
+    get_eta_and_chi (model, nr[centre], freq*shift[centre], eta_ray[centre], chi_ray[centre]);
+
+    // Walk from the centre towards the first point on the ray
+    Real tau = 0.0;
+    Size n   = centre;
+
+    while ((n > first_ray) && (tau < tau_max))
+    {
+        n--;
+
+        get_eta_and_chi (model, nr[n], freq*shift[n], eta_ray[n], chi_ray[n]);
+
+        tau += half * (chi_ray[n] + chi_ray[n+1]) * dZ[n];
+    }
+
+    scratch.first = n;
+
+    // Walk from the centre towards the last point on the ray
+    tau = 0.0;
+    n   = centre;
+
+    while ((n < last_ray) && (tau < tau_max))
+    {
+        n++;
+
+        get_eta_and_chi (model, nr[n], freq*shift[n], eta_ray[n], chi_ray[n]);
+
+        tau += half * (chi_ray[n-1] + chi_ray[n]) * dZ[n-1];
+    }
+
+    scratch.last  = n;
+    scratch.n_tot = (scratch.last+1) - scratch.first;
+}
+
+
 accel inline void Solver :: set_data (
-    const Size   crt,
-    const Size   nxt,
-    const double shift_crt,
-    const double shift_nxt,
-    const double dZ_loc,
-    const double dshift_max,
-    const int    increment,
-          Size&  id1,
-          Size&  id2 )
+          Scratch& scratch,
+    const Size     crt,
+    const Size     nxt,
+    const double   shift_crt,
+    const double   shift_nxt,
+    const double   dZ_loc,
+    const double   dshift_max,
+    const int      increment,
+          Size&    id1,
+          Size&    id2 )
 {
-    Vector<double>& dZ    = dZ_   ();
-    Vector<Size  >& nr    = nr_   ();
-    Vector<double>& shift = shift_();
+    Vector<double>& dZ    = scratch.dZ;
+    Vector<Size  >& nr    = scratch.nr;
+    Vector<double>& shift = scratch.shift;
 
     const double dshift     = shift_nxt - shift_crt;
     const double dshift_abs = fabs (dshift);
@@ -482,110 +1203,195 @@ accel inline Real trap (const Real x_crt, const Real x_nxt, const double dZ)
 
 
 
+///  Short-characteristics solution for the intensity arriving in origin o along
+///  ray r, integrated from the origin outwards with the frequency loop innermost.
+///  Every segment contributes its (linear) source function, attenuated by the
+///  optical depth in front of it, and the stepping stops once all frequencies
+///  are optically invisible (tau_max if set, else invisible to precision). The
+///  weight of the source function in the origin is added to the diagonal of the
+///  Lambda operator, and the intensity is added to J.
+///    @param[in]  scratch : scratch memory of the calling thread
+///    @param[in]  o       : index of the origin
+///    @param[in]  r       : index of the ray
+///    @param[out] I       : intensity in the origin for each frequency
+//////////////////////////////////////////////////////////////////////////////////
 accel inline void Solver :: solve_shortchar_order_0 (
-          Model& model,
-    const Size   o,
-    const Size   r,
-    const double dshift_max)
+          Model&        model,
+          Scratch&      scratch,
+    const Size          o,
+    const Size          r,
+          Vector<Real>& I )
 {
-    Vector<Real>& eta_c = eta_c_();
-    Vector<Real>& eta_n = eta_n_();
+    const Real tau_cut = (model.parameters.tau_max > 0.0) ? model.parameters.tau_max : 50.0;
 
-    Vector<Real>& chi_c = chi_c_();
-    Vector<Real>& chi_n = chi_n_();
+    Vector<Real>& S_c   = scratch.eta_c;   // source function in the current point
+    Vector<Real>& chi_c = scratch.chi_c;   // opacity         in the current point
+    Vector<Real>& trans = scratch.eta_n;   // transmission (exp(-tau)) up to the current point
+    Vector<Real>& tau   = scratch.tau;     // optical depth   up to the current point
+    Vector<Real>& L_loc = scratch.chi_n;   // weight of the source function in the origin over chi
+
+    Real eta, chi_n;
+
+    // Optical properties in the origin
+    for (Size f = 0; f < model.parameters.nfreqs(); f++)
+    {
+        const Real freq = model.radiation.frequencies.nu(o, f);
 
-    Vector<Real>& tau = tau_();
+        get_eta_and_chi (model, o, freq, eta, chi_c[f]);
 
+        S_c  [f] = eta / chi_c[f];
+        trans[f] = one;
+        tau  [f] = 0.0;
+        L_loc[f] = 0.0;
+        I    [f] = 0.0;
+    }
 
-    double  Z = 0.0;   // distance along ray
-    double dZ = 0.0;   // last distance increment
+    double  Z      = 0.0;   // distance along ray
+    double dZ      = 0.0;   // last distance increment
+    double shift_n = 1.0;   // Doppler shift in the next point
 
     Size crt = o;
     Size nxt = model.geometry.get_next (o, r, o, Z, dZ);
 
     if (model.geometry.valid_point (nxt))
     {
-        double shift_c = 1.0;
-        double shift_n = model.geometry.get_shift <CoMoving> (o, r, nxt, Z);
+        shift_n = model.geometry.get_shift <CoMoving> (o, r, nxt, Z);
+
+        bool first_segment = true;
+        Size n_active      = model.parameters.nfreqs();
+
+        while (n_active > 0)
+        {
+            n_active = 0;
+
+            for (Size f = 0; f < model.parameters.nfreqs(); f++)
+            {
+                if (tau[f] > tau_cut) {continue;}
+
+                n_active++;
+
+                const Real freq = model.radiation.frequencies.nu(o, f);
+
+                get_eta_and_chi (model, nxt, freq*shift_n, eta, chi_n);
+
+                const Real S_n = eta / chi_n;
+
+                const Real dtau         = half * (chi_c[f] + chi_n) * dZ;
+                const Real one_min_expt = -expm1 (-dtau);
+                const Real expt         = one - one_min_expt;
+
+                // Weights of the source function in the current (downstream) and
+                // next (upstream) point (series expansion for small dtau)
+                Real w_c, w_n;
+
+                if (dtau < 1.0e-3)
+                {
+                    w_c = dtau * (half - dtau * (ONE_SIXTH - dtau / 24.0));
+                    w_n = dtau * (half - dtau * (ONE_THIRD - 0.125 * dtau));
+                }
+                else
+                {
+                    const Real one_min_expt_over_dtau = one_min_expt / dtau;
 
-        for (Size f = 0; f < model.parameters.nfreqs(); f++)
-        {
-            const Real freq = model.radiation.frequencies.nu(o, f);
+                    w_c = one - one_min_expt_over_dtau;
+                    w_n = one_min_expt_over_dtau - expt;
+                }
 
-            get_eta_and_chi (model, crt, freq,         eta_c[f], chi_c[f]);
-            get_eta_and_chi (model, nxt, freq*shift_n, eta_n[f], chi_n[f]);
+                if (first_segment)
+                {
+                    L_loc[f] = w_c / chi_c[f];
+                }
 
-            const Real drho = trap (eta_c[f], eta_n[f], dZ);
-            const Real dtau = trap (chi_c[f], chi_n[f], dZ);
+                I    [f] += trans[f] * (w_c * S_c[f] + w_n * S_n);
+                trans[f] *= expt;
+                tau  [f] += dtau;
+                S_c  [f]  = S_n;
+                chi_c[f]  = chi_n;
+            }
 
-            tau[f]                   = dtau;
-            model.radiation.I(r,o,f) = drho * expf(-tau[f]);
-        }
+            first_segment = false;
 
-        while (model.geometry.not_on_boundary (nxt))
-        {
-            crt     = nxt;
-            shift_c = shift_n;
-              eta_c =   eta_n;
-              chi_c =   chi_n;
+            if (!model.geometry.not_on_boundary (nxt)) {break;}
 
+            crt = nxt;
             model.geometry.get_next (o, r, crt, nxt, Z, dZ, shift_n);
+        }
 
-            for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        // Add the attenuated boundary intensity where the ray was not cut
+        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        {
+            if (tau[f] <= tau_cut)
             {
                 const Real freq = model.radiation.frequencies.nu(o, f);
 
-                get_eta_and_chi (model, nxt, freq*shift_n, eta_n[f], chi_n[f]);
-
-                const Real drho = trap (eta_c[f], eta_n[f], dZ);
-                const Real dtau = trap (chi_c[f], chi_n[f], dZ);
-
-                tau[f]                   += dtau;
-                model.radiation.I(r,o,f) += drho * expf(-tau[f]);
+                I[f] += trans[f] * boundary_intensity (model, nxt, freq*shift_n);
             }
         }
-
+    }
+    else
+    {
         for (Size f = 0; f < model.parameters.nfreqs(); f++)
         {
             const Real freq = model.radiation.frequencies.nu(o, f);
 
-            model.radiation.I(r,o,f) += boundary_intensity(model, nxt, freq*shift_n) * expf(-tau[f]);
-            model.radiation.J(  o,f) += model.geometry.rays.weight[r] * model.radiation.I(r,o,f);
+            I[f] = boundary_intensity (model, o, freq);
         }
     }
 
-    else
+    const Frequencies    &freqs     = model.radiation.frequencies;
+    const Thermodynamics &thermodyn = model.thermodynamics;
+
+    const Real w_ang = model.geometry.rays.get_weight (o, r);
+
+    for (Size f = 0; f < model.parameters.nfreqs(); f++)
     {
-        for (Size f = 0; f < model.parameters.nfreqs(); f++)
+        model.radiation.J(o,f) += w_ang * I[f];
+
+        // Diagonal of the Lambda operator (in the same form as update_Lambda)
+        if (freqs.appears_in_line_integral[f] && (L_loc[f] > 0.0))
         {
-            const Real freq = model.radiation.frequencies.nu(o, f);
+            const Size l = freqs.corresponding_l_for_spec[f];   // index of species
+            const Size k = freqs.corresponding_k_for_tran[f];   // index of transition
+            const Size z = freqs.corresponding_z_for_line[f];   // index of quadrature point
 
-            model.radiation.I(r,o,f)  = boundary_intensity(model, crt, freq);
-            model.radiation.J(  o,f) += model.geometry.rays.weight[r] * model.radiation.I(r,o,f);
+            LineProducingSpecies &lspec = model.lines.lineProducingSpecies[l];
+
+            const Real freq_line = lspec.linedata.frequency[k];
+            const Real invr_mass = lspec.linedata.inverse_mass;
+            const Real constante = lspec.linedata.A[k] * lspec.quadrature.weights[z] * w_ang;
+
+            const Real frq = freqs.nu(o, f);
+            const Real phi = thermodyn.profile (invr_mass, o, freq_line, frq);
+
+            lspec.lambda.add_element (o, k, o, constante * frq * phi * L_loc[f]);
         }
     }
 }
 
 
-accel inline void Solver :: update_Lambda (Model &model, const Size rr, const Size f)
+accel inline void Solver :: update_Lambda (
+          Model   &model,
+    const Scratch &scratch,
+    const Size     rr,
+    const Size     f  )
 {
     const Frequencies    &freqs     = model.radiation.frequencies;
     const Thermodynamics &thermodyn = model.thermodynamics;
 
     if (freqs.appears_in_line_integral[f])
     {
-        const Size first = first_();
-        const Size last  = last_ ();
-        const Size n_tot = n_tot_();
+        const Size first = scratch.first;
+        const Size last  = scratch.last;
+        const Size n_tot = scratch.n_tot;
 
-        Vector<Size  >& nr          = nr_         ();
-        Vector<double>& shift       = shift_      ();
-        Vector<Real  >& L_diag      = L_diag_     ();
-        Matrix<Real  >& L_upper     = L_upper_    ();
-        Matrix<Real  >& L_lower     = L_lower_    ();
-        Vector<Real  >& inverse_chi = inverse_chi_();
+        const Vector<Size  >& nr          = scratch.nr;
+        const Vector<double>& shift       = scratch.shift;
+        const Vector<Real  >& L_diag      = scratch.L_diag;
+        const Matrix<Real  >& L_upper     = scratch.L_upper;
+        const Matrix<Real  >& L_lower     = scratch.L_lower;
+        const Vector<Real  >& inverse_chi = scratch.inverse_chi;
 
-        const Real w_ang = two * model.geometry.rays.weight[rr];
+        const Real w_ang = two * model.geometry.rays.get_weight (nr[centre], rr);
 
         const Size l = freqs.corresponding_l_for_spec[f];   // index of species
         const Size k = freqs.corresponding_k_for_tran[f];   // index of transition
@@ -603,6 +1409,9 @@ accel inline void Solver :: update_Lambda (Model &model, const Size rr, const Si
 
         lspec.lambda.add_element(nr[centre], k, nr[centre], L);
 
+        // Off-diagonal contributions smaller than this are dropped
+        const Real L_min = lambda_threshold * fabs (L);
+
         for (long m = 0; (m < n_off_diag) && (m+1 < n_tot); m++)
         {
             if (centre >= first+m+1) // centre-m-1 >= first
@@ -613,7 +1422,8 @@ accel inline void Solver :: update_Lambda (Model &model, const Size rr, const Si
                 phi = thermodyn.profile (invr_mass, nr[n], freq_line, frq);
                 L   = constante * frq * phi * L_lower(m,n) * inverse_chi[n];
 
-                lspec.lambda.add_element(nr[centre], k, nr[n], L);
+                if (fabs (L) >= L_min) {lspec.lambda.add_element(nr[centre], k, nr[n], L, lambda_max_entries);}
+                else                   {lspec.lambda.n_dropped[nr[centre]]++;}
             }
 
             if (centre+m+1 <= last) // centre+m+1 < last
@@ -624,7 +1434,8 @@ accel inline void Solver :: update_Lambda (Model &model, const Size rr, const Si
                 phi = thermodyn.profile (invr_mass, nr[n], freq_line, frq);
                 L   = constante * frq * phi * L_upper(m,n) * inverse_chi[n];
 
-                lspec.lambda.add_element(nr[centre], k, nr[n], L);
+                if (fabs (L) >= L_min) {lspec.lambda.add_element(nr[centre], k, nr[n], L, lambda_max_entries);}
+                else                   {lspec.lambda.n_dropped[nr[centre]]++;}
             }
         }
     }
@@ -636,49 +1447,66 @@ accel inline void Solver :: update_Lambda (Model &model, const Size rr, const Si
 ///    @param[in] w : width index
 ///////////////////////////////////////////////////////////////////////
 accel inline void Solver :: solve_feautrier_order_2 (
-          Model& model,
-    const Size   o,
-    const Size   rr,
-    const Size   ar,
-    const Size   f  )
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar,
+    const Size     f  )
 {
     const Real freq = model.radiation.frequencies.nu(o, f);
 
     Real eta_c, chi_c, dtau_c, term_c;
     Real eta_n, chi_n, dtau_n, term_n;
 
-    const Size first = first_();
-    const Size last  = last_ ();
-    const Size n_tot = n_tot_();
+    const Size first = scratch.first;
+    const Size last  = scratch.last;
+    const Size n_tot = scratch.n_tot;
 
-    Vector<double>& dZ    = dZ_   ();
-    Vector<Size  >& nr    = nr_   ();
-    Vector<double>& shift = shift_();
+    Vector<double>& dZ    = scratch.dZ;
+    Vector<Size  >& nr    = scratch.nr;
+    Vector<double>& shift = scratch.shift;
 
-    Vector<Real>& inverse_chi = inverse_chi_();
+    Vector<Real>& inverse_chi = scratch.inverse_chi;
 
-    Vector<Real>& Su = Su_();
-    Vector<Real>& Sv = Sv_();
+    Vector<Real>& Su = scratch.Su;
+    Vector<Real>& Sv = scratch.Sv;
 
-    Vector<Real>& A         = A_        ();
-    Vector<Real>& C         = C_        ();
-    Vector<Real>& inverse_A = inverse_A_();
-    Vector<Real>& inverse_C = inverse_C_();
+    Vector<Real>& A         = scratch.A;
+    Vector<Real>& C         = scratch.C;
+    Vector<Real>& inverse_A = scratch.inverse_A;
+    Vector<Real>& inverse_C = scratch.inverse_C;
 
-    Vector<Real>& FF = FF_();
-    Vector<Real>& FI = FI_();
-    Vector<Real>& GG = GG_();
-    Vector<Real>& GI = GI_();
-    Vector<Real>& GP = GP_();
+    Vector<Real>& FF = scratch.FF;
+    Vector<Real>& FI = scratch.FI;
+    Vector<Real>& GG = scratch.GG;
+    Vector<Real>& GI = scratch.GI;
+    Vector<Real>& GP = scratch.GP;
 
-    Vector<Real>& L_diag  = L_diag_ ();
-    Matrix<Real>& L_upper = L_upper_();
-    Matrix<Real>& L_lower = L_lower_();
+    Vector<Real>& L_diag  = scratch.L_diag;
+    Matrix<Real>& L_upper = scratch.L_upper;
+    Matrix<Real>& L_lower = scratch.L_lower;
+
+    /// Truncated rays have their optical properties cached (see truncate_ray)
+    const bool truncated = (model.parameters.tau_max > 0.0);
+
+    Vector<Real>& eta_ray = scratch.eta_ray;
+    Vector<Real>& chi_ray = scratch.chi_ray;
 
 
     // Get optical properties for first two elements
-    get_eta_and_chi (model, nr[first  ], freq*shift[first  ], eta_c, chi_c);
-    get_eta_and_chi (model, nr[first+1], freq*shift[first+1], eta_n, chi_n);
+    if (truncated)
+    {
+        eta_c = eta_ray[first  ];
+        chi_c = chi_ray[first  ];
+        eta_n = eta_ray[first+1];
+        chi_n = chi_ray[first+1];
+    }
+    else
+    {
+        get_eta_and_chi (model, nr[first  ], freq*shift[first  ], eta_c, chi_c);
+        get_eta_and_chi (model, nr[first+1], freq*shift[first+1], eta_n, chi_n);
+    }
 
     inverse_chi[first  ] = 1.0 / chi_c;
     inverse_chi[first+1] = 1.0 / chi_n;
@@ -695,7 +1523,11 @@ accel inline void Solver :: solve_feautrier_order_2 (
 
     const Real Bf_min_Cf = one + two * inverse_dtau_f;
     const Real Bf        = Bf_min_Cf + C[first];
-    const Real I_bdy_f   = boundary_intensity (model, nr[first], freq*shift[first]);
+
+    // At a truncation point, the radiation field is thermalised
+    const Real I_bdy_f   = (truncated && model.geometry.not_on_boundary (nr[first]))
+                           ? term_c
+                           : boundary_intensity (model, nr[first], freq*shift[first]);
 
     Su[first]  = term_c + two * I_bdy_f * inverse_dtau_f;
     Su[first] /= Bf;
@@ -714,7 +1546,15 @@ accel inline void Solver :: solve_feautrier_order_2 (
          chi_c =  chi_n;
 
         // Get new radiative properties
-        get_eta_and_chi (model, nr[n+1], freq*shift[n+1], eta_n, chi_n);
+        if (truncated)
+        {
+            eta_n = eta_ray[n+1];
+            chi_n = chi_ray[n+1];
+        }
+        else
+        {
+            get_eta_and_chi (model, nr[n+1], freq*shift[n+1], eta_n, chi_n);
+        }
 
         inverse_chi[n+1] = 1.0 / chi_n;
 
@@ -747,7 +1587,10 @@ accel inline void Solver :: solve_feautrier_order_2 (
 
     const Real denominator = one / (Bl * FF[last-1] + Bl_min_Al);
 
-    const Real I_bdy_l = boundary_intensity (model, nr[last], freq*shift[last]);
+    // At a truncation point, the radiation field is thermalised
+    const Real I_bdy_l = (truncated && model.geometry.not_on_boundary (nr[last]))
+                         ? term_n
+                         : boundary_intensity (model, nr[last], freq*shift[last]);
 
     Su[last] = term_n + two * I_bdy_l * inverse_dtau_l;
     Su[last] = (A[last] * Su[last-1] + Su[last]) * (one + FF[last-1]) * denominator;
@@ -776,6 +1619,74 @@ accel inline void Solver :: solve_feautrier_order_2 (
             L_diag[centre] = (one + FF[centre-1]) / (Bl_min_Al + Bl*FF[centre-1]);
         }
     }
+    else if (!full_lambda)
+    {
+        /// Only the centre row of the inverse Feautrier operator is required,
+        /// i.e. the diagonal elements in the band [n_lo, n_hi] around centre.
+        const Size n_lo = (centre >= first + n_off_diag) ? centre - n_off_diag : first;
+        const Size n_hi = (centre + n_off_diag <= last ) ? centre + n_off_diag : last;
+
+        /// Write economically: G[last] = (B[last] - A[last]) / A[last];
+        GG[last] = half * Bl_min_Al * dtau_n * dtau_n;
+        GI[last] = one / (one + GG[last]);
+        GP[last] = GG[last] * GI[last];
+
+        if (n_hi == last)
+        {
+            L_diag[last] = (one + FF[last-1]) / (Bl_min_Al + Bl*FF[last-1]);
+        }
+
+        for (long n = last-1; n > n_lo; n--) // use long in reverse loops!
+        {
+            if (n >= centre)
+            {
+                Su[n] += Su[n+1] * FI[n];
+            }
+
+            GG[n] = (C[n] * GP[n+1] + one) * inverse_A[n];
+            GI[n] = one / (one + GG[n]);
+            GP[n] = GG[n] * GI[n];
+
+            if (n <= n_hi)
+            {
+                L_diag[n] = inverse_C[n] / (FF[n] + GP[n+1]);
+            }
+        }
+
+        if (n_lo == centre)
+        {
+            Su[centre] += Su[centre+1] * FI[centre];
+        }
+
+        if (n_lo == first)
+        {
+            L_diag[first] = (one + GG[first+1]) / (Bf_min_Cf + Bf*GG[first+1]);
+        }
+        else
+        {
+            L_diag[n_lo]  = inverse_C[n_lo] / (FF[n_lo] + GP[n_lo+1]);
+        }
+
+        /// Off-diagonal elements of the centre row follow from the diagonal
+        /// ones by accumulating the products of FI (upper) and GI (lower).
+        Real FI_prod = one;
+        Real GI_prod = one;
+
+        for (Size m = 0; m < n_off_diag; m++)
+        {
+            if (centre+m+1 <= n_hi)
+            {
+                FI_prod                *= FI[centre+m];
+                L_upper(m, centre+m+1)  = L_diag[centre+m+1] * FI_prod;
+            }
+
+            if (centre >= n_lo+m+1)
+            {
+                GI_prod                *= GI[centre-m];
+                L_lower(m, centre-m-1)  = L_diag[centre-m-1] * GI_prod;
+            }
+        }
+    }
     else
     {
         /// Write economically: G[last] = (B[last] - A[last]) / A[last];
@@ -817,16 +1728,394 @@ accel inline void Solver :: solve_feautrier_order_2 (
 }
 
 
+///  Solver for the Feautrier equation along ray pairs using the Hermitian
+///  4th-order scheme (Auer 1976, JQSRT 16, 931). The source function enters
+///  each row through a three-point stencil (Ra, Rb, Rc), such that the error
+///  is O(dtau^4) rather than O(dtau^2). The boundary conditions include the
+///  dtau^3 term of the Taylor expansion and the optical depth increments are
+///  corrected for the curvature of the opacity, such that neither spoils this.
+///  Rows in which the optical depth increments are too large (to keep the
+///  off-diagonal elements positive) or too different (to keep the weights
+///  positive) fall back to the 2nd-order scheme, keeping it stable and robust.
+///  The Lambda operator (centre row only) is T^{-1} R, with T the Feautrier
+///  matrix and R the stencil weights.
+///    @param[in] f : frequency index
+/////////////////////////////////////////////////////////////////////////////
+accel inline void Solver :: solve_feautrier_order_4 (
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar,
+    const Size     f  )
+{
+    const Real freq = model.radiation.frequencies.nu(o, f);
+
+    Real eta_c, chi_c, dtau_c, term_c;
+    Real eta_n, chi_n, dtau_n, term_n;
+    Real        chi_p;
+
+    const Size first = scratch.first;
+    const Size last  = scratch.last;
+
+    Vector<double>& dZ    = scratch.dZ;
+    Vector<Size  >& nr    = scratch.nr;
+    Vector<double>& shift = scratch.shift;
+
+    Vector<Real>& inverse_chi = scratch.inverse_chi;
+
+    Vector<Real>& Su = scratch.Su;
+    Vector<Real>& Sv = scratch.Sv;
+
+    Vector<Real>& A         = scratch.A;
+    Vector<Real>& C         = scratch.C;
+    Vector<Real>& inverse_A = scratch.inverse_A;
+    Vector<Real>& inverse_C = scratch.inverse_C;
+
+    Vector<Real>& FF = scratch.FF;
+    Vector<Real>& FI = scratch.FI;
+    Vector<Real>& GG = scratch.GG;
+    Vector<Real>& GI = scratch.GI;
+    Vector<Real>& GP = scratch.GP;
+
+    Vector<Real>& Ra = scratch.Ra;
+    Vector<Real>& Rb = scratch.Rb;
+    Vector<Real>& Rc = scratch.Rc;
+
+    Vector<Real>& L_diag  = scratch.L_diag;
+    Matrix<Real>& L_upper = scratch.L_upper;
+    Matrix<Real>& L_lower = scratch.L_lower;
+
+    /// Truncated rays have their optical properties cached (see truncate_ray)
+    const bool truncated = (model.parameters.tau_max > 0.0);
+
+    Vector<Real>& eta_ray = scratch.eta_ray;
+    Vector<Real>& chi_ray = scratch.chi_ray;
+
+    const Real third = one / 3.0;
+    const Real sixth = one / 6.0;
+
+
+    // Get optical properties for first two elements
+    if (truncated)
+    {
+        eta_c = eta_ray[first  ];
+        chi_c = chi_ray[first  ];
+        eta_n = eta_ray[first+1];
+        chi_n = chi_ray[first+1];
+    }
+    else
+    {
+        get_eta_and_chi (model, nr[first  ], freq*shift[first  ], eta_c, chi_c);
+        get_eta_and_chi (model, nr[first+1], freq*shift[first+1], eta_n, chi_n);
+    }
+
+    inverse_chi[first  ] = 1.0 / chi_c;
+    inverse_chi[first+1] = 1.0 / chi_n;
+
+    term_c = eta_c * inverse_chi[first  ];
+    term_n = eta_n * inverse_chi[first+1];
+    dtau_n = half * (chi_c + chi_n) * dZ[first];
+
+    // Set boundary conditions, from the Taylor expansion of u up to 4th order,
+    // with u' = u - I_bdy and u'' = u - S, and dS/dtau from the first points
+    const Real inverse_dtau_f = one / dtau_n;
+    const bool hermitian_f    = (dtau_n * dtau_n < 12.0);   // keeps C[first] > 0
+
+    C[first] = two * inverse_dtau_f * inverse_dtau_f;
+
+    Real Bf_min_Cf = one + two * inverse_dtau_f;
+    Real I_fac_f   =       two * inverse_dtau_f;
+    Real Rd_f      = 0.0;   // weight of S[first+2] in the first row
+
+    if (hermitian_f)
+    {
+        // Two-point dS/dtau, refined below if the ray has a third point
+         C[first] -= sixth;
+        Bf_min_Cf += sixth * dtau_n;
+        I_fac_f   += sixth * dtau_n;
+        Rb[first]  = two * third;
+        Rc[first]  =       third;
+    }
+    else
+    {
+        Rb[first]  = one;
+        Rc[first]  = 0.0;
+    }
+
+    inverse_C[first] = one / C[first];
+
+    const Real Bf = Bf_min_Cf + C[first];
+
+    // At a truncation point, the radiation field is thermalised
+    const Real I_bdy_f   = (truncated && model.geometry.not_on_boundary (nr[first]))
+                           ? term_c
+                           : boundary_intensity (model, nr[first], freq*shift[first]);
+
+    Su[first]  = Rb[first] * term_c + Rc[first] * term_n + I_fac_f * I_bdy_f;
+    Su[first] /= Bf;
+
+    /// F[first] = (B[first] - C[first]) / C[first];
+    FF[first] = Bf_min_Cf * inverse_C[first];
+    FI[first] = one / (one + FF[first]);
+
+    // Source function at the previous point
+    Real term_p = 0.0;
+
+
+    /// Set body of Feautrier matrix
+    for (Size n = first+1; n < last; n++)
+    {
+        chi_p  = chi_c;
+        term_p = term_c;
+        term_c = term_n;
+        dtau_c = dtau_n;
+         eta_c =  eta_n;
+         chi_c =  chi_n;
+
+        // Get new radiative properties
+        if (truncated)
+        {
+            eta_n = eta_ray[n+1];
+            chi_n = chi_ray[n+1];
+        }
+        else
+        {
+            get_eta_and_chi (model, nr[n+1], freq*shift[n+1], eta_n, chi_n);
+        }
+
+        inverse_chi[n+1] = 1.0 / chi_n;
+
+        term_n = eta_n * inverse_chi[n+1];
+        dtau_n = half * (chi_c + chi_n) * dZ[n];
+
+        /// Correct the trapezium rule for the curvature of chi (through the
+        /// points n-1, n and n+1), otherwise the optical depth increments
+        /// themselves would only be 2nd-order accurate. This is only done
+        /// for comparable distance increments, and if it keeps dtau positive.
+        const Real chi_curv = two * ( (chi_n - chi_c) / dZ[n  ]
+                                     -(chi_c - chi_p) / dZ[n-1]) / (dZ[n-1] + dZ[n]);
+        const Real dtau_cor = dZ[n] * dZ[n] * dZ[n] * chi_curv / 12.0;
+
+        const bool comparable = (dZ[n] < two * dZ[n-1]) && (dZ[n-1] < two * dZ[n]);
+
+        if (comparable && (fabs (dtau_cor) < half * dtau_n))
+        {
+            dtau_n -= dtau_cor;
+        }
+
+        const Real dtau_sum = dtau_c + dtau_n;
+
+        if ((n == first+1) && hermitian_f && (dtau_n > half * dtau_c))
+        {
+            /// Three-point dS/dtau in the first boundary condition (unless the
+            /// second increment is much smaller, which would amplify noise)
+            const Real d1 = -(two*dtau_c + dtau_n) / (dtau_c * dtau_sum);
+            const Real d2 =  dtau_sum              / (dtau_c * dtau_n  );
+            const Real d3 = -dtau_c                / (dtau_n * dtau_sum);
+
+            Rb[first] = sixth * (5.0 + dtau_c * d1);
+            Rc[first] = sixth * (one + dtau_c * d2);
+            Rd_f      = sixth * (      dtau_c * d3);
+
+            Su[first]  = Rb[first] * term_p + Rc[first] * term_c + Rd_f * term_n + I_fac_f * I_bdy_f;
+            Su[first] /= Bf;
+        }
+
+        A[n] = two / (dtau_sum * dtau_c);
+        C[n] = two / (dtau_sum * dtau_n);
+
+        /// Weights of the neighbouring source functions, such that u'' = u - S
+        /// is integrated exactly for polynomials up to 4th degree. They are
+        /// only used if they are all positive, i.e. the ratio of the optical
+        /// depth increments is below the golden ratio. Otherwise (e.g. for
+        /// nearly coinciding points) they would amplify any noise in S.
+        const Real a = (dtau_c*dtau_c + dtau_c*dtau_n - dtau_n*dtau_n) / (6.0 * dtau_c * dtau_sum);
+        const Real c = (dtau_n*dtau_n + dtau_c*dtau_n - dtau_c*dtau_c) / (6.0 * dtau_n * dtau_sum);
+
+        if ((a >= 0.0) && (c >= 0.0) && (A[n] > a) && (C[n] > c))
+        {
+             A[n] -= a;
+             C[n] -= c;
+            Ra[n]  = a;
+            Rb[n]  = one - a - c;
+            Rc[n]  = c;
+        }
+        else
+        {
+            Ra[n] = 0.0;
+            Rb[n] = one;
+            Rc[n] = 0.0;
+        }
+
+        inverse_A[n] = one / A[n];
+        inverse_C[n] = one / C[n];
+
+        /// B[n] = one + A[n] + C[n] still holds, so the elimination is as before
+        Su[n] = Ra[n] * term_p + Rb[n] * term_c + Rc[n] * term_n;
+
+        FF[n] = (A[n] * FF[n-1] * FI[n-1] + one) * inverse_C[n];
+        FI[n] = one / (one + FF[n]);
+        Su[n] = (A[n] * Su[n-1] + Su[n]) * FI[n] * inverse_C[n];
+    }
+
+
+    /// Set boundary conditions
+    const Real inverse_dtau_l = one / dtau_n;
+    const bool hermitian_l    = (dtau_n * dtau_n < 12.0);   // keeps A[last] > 0
+
+    A[last] = two * inverse_dtau_l * inverse_dtau_l;
+
+    Real Bl_min_Al = one + two * inverse_dtau_l;
+    Real I_fac_l   =       two * inverse_dtau_l;
+    Real Rd_l      = 0.0;   // weight of S[last-2] in the last row
+
+    if (hermitian_l && (last > first+1) && (dtau_c > half * dtau_n))
+    {
+        /// Three-point dS/dtau (towards the inside of the ray)
+        const Real dtau_sum = dtau_n + dtau_c;
+
+        const Real d1 = -(two*dtau_n + dtau_c) / (dtau_n * dtau_sum);
+        const Real d2 =  dtau_sum              / (dtau_n * dtau_c  );
+        const Real d3 = -dtau_n                / (dtau_c * dtau_sum);
+
+         A[last] -= sixth;
+        Bl_min_Al += sixth * dtau_n;
+        I_fac_l   += sixth * dtau_n;
+        Rb[last]   = sixth * (5.0 + dtau_n * d1);
+        Ra[last]   = sixth * (one + dtau_n * d2);
+        Rd_l       = sixth * (      dtau_n * d3);
+    }
+    else if (hermitian_l)
+    {
+         A[last] -= sixth;
+        Bl_min_Al += sixth * dtau_n;
+        I_fac_l   += sixth * dtau_n;
+        Rb[last]   = two * third;
+        Ra[last]   =       third;
+    }
+    else
+    {
+        Rb[last] = one;
+        Ra[last] = 0.0;
+    }
+
+    const Real Bl = Bl_min_Al + A[last];
+
+    const Real denominator = one / (Bl * FF[last-1] + Bl_min_Al);
+
+    // At a truncation point, the radiation field is thermalised
+    const Real I_bdy_l = (truncated && model.geometry.not_on_boundary (nr[last]))
+                         ? term_n
+                         : boundary_intensity (model, nr[last], freq*shift[last]);
+
+    Su[last] = Ra[last] * term_c + Rb[last] * term_n + Rd_l * term_p + I_fac_l * I_bdy_l;
+    Su[last] = (A[last] * Su[last-1] + Su[last]) * (one + FF[last-1]) * denominator;
+
+
+    /// The centre row of Lambda = T^{-1} R involves the centre row of the
+    /// inverse Feautrier matrix T^{-1} up to two elements further out, since
+    /// the boundary rows of R reach two points into the ray.
+    const Size n_band = n_off_diag + 2;
+
+    const Size n_lo = (centre >= first + n_band) ? centre - n_band : first;
+    const Size n_hi = (centre + n_band <= last ) ? centre + n_band : last;
+
+    /// G[last] = (B[last] - A[last]) / A[last];
+    GG[last] = Bl_min_Al / A[last];
+    GI[last] = one / (one + GG[last]);
+    GP[last] = GG[last] * GI[last];
+
+    if (n_hi == last)
+    {
+        L_diag[last] = (one + FF[last-1]) / (Bl_min_Al + Bl*FF[last-1]);
+    }
+
+    for (long n = last-1; n > n_lo; n--) // use long in reverse loops!
+    {
+        if (n >= centre)
+        {
+            Su[n] += Su[n+1] * FI[n];
+        }
+
+        GG[n] = (C[n] * GP[n+1] + one) * inverse_A[n];
+        GI[n] = one / (one + GG[n]);
+        GP[n] = GG[n] * GI[n];
+
+        if (n <= n_hi)
+        {
+            L_diag[n] = inverse_C[n] / (FF[n] + GP[n+1]);
+        }
+    }
+
+    if (n_lo == centre)
+    {
+        Su[centre] += Su[centre+1] * FI[centre];
+    }
+
+    if (n_lo == first)
+    {
+        L_diag[first] = (one + GG[first+1]) / (Bf_min_Cf + Bf*GG[first+1]);
+    }
+    else
+    {
+        L_diag[n_lo]  = inverse_C[n_lo] / (FF[n_lo] + GP[n_lo+1]);
+    }
+
+    /// Centre row of T^{-1} (stored in Sv), from its diagonal elements
+    Real FI_prod = one;
+    Real GI_prod = one;
+
+    Sv[centre] = L_diag[centre];
+
+    for (Size m = 0; m < n_band; m++)
+    {
+        if (centre+m+1 <= n_hi)
+        {
+            FI_prod         *= FI[centre+m];
+            Sv[centre+m+1]   = L_diag[centre+m+1] * FI_prod;
+        }
+
+        if (centre >= n_lo+m+1)
+        {
+            GI_prod         *= GI[centre-m];
+            Sv[centre-m-1]   = L_diag[centre-m-1] * GI_prod;
+        }
+    }
+
+    /// Centre row of Lambda, in the layout expected by update_Lambda
+    const Size l_lo = (centre >= first + n_off_diag) ? centre - n_off_diag : first;
+    const Size l_hi = (centre + n_off_diag <= last ) ? centre + n_off_diag : last;
+
+    for (Size n = l_lo; n <= l_hi; n++)
+    {
+        Real L = Sv[n] * Rb[n];
+
+        if (n > n_lo) {L += Sv[n-1] * Rc[n-1];}
+        if (n < n_hi) {L += Sv[n+1] * Ra[n+1];}
+
+        if (n == first+2) {L += Sv[first] * Rd_f;}
+        if (n+2 == last ) {L += Sv[last ] * Rd_l;}
+
+        if      (n < centre) {L_lower (centre-n-1, n) = L;}
+        else if (n > centre) {L_upper (n-centre-1, n) = L;}
+        else                 {L_diag  [centre]        = L;}
+    }
+}
+
+
+
 ///  Solver for Feautrier equation along ray pairs using the (ordinary)
 ///  2nd-order solver, without adaptive optical depth increments
 ///    @param[in] w : width index
 ///////////////////////////////////////////////////////////////////////
 accel inline void Solver :: image_feautrier_order_2 (
-          Model& model,
-    const Size   o,
-    const Size   rr,
-    const Size   ar,
-    const Size   f  )
+          Model&   model,
+          Scratch& scratch,
+    const Size     o,
+    const Size     rr,
+    const Size     ar,
+    const Size     f  )
 {
     const Real freq = model.radiation.frequencies.nu(o, f);
 
@@ -835,33 +2124,33 @@ accel inline void Solver :: image_feautrier_order_2 (
     Real eta_c, chi_c, dtau_c, term_c;
     Real eta_n, chi_n, dtau_n, term_n;
 
-    const Size first = first_();
-    const Size last  = last_ ();
-    const Size n_tot = n_tot_();
+    const Size first = scratch.first;
+    const Size last  = scratch.last;
+    const Size n_tot = scratch.n_tot;
 
-    Vector<double>& dZ    = dZ_   ();
-    Vector<Size  >& nr    = nr_   ();
-    Vector<double>& shift = shift_();
+    Vector<double>& dZ    = scratch.dZ;
+    Vector<Size  >& nr    = scratch.nr;
+    Vector<double>& shift = scratch.shift;
 
-    Vector<Real>& inverse_chi = inverse_chi_();
+    Vector<Real>& inverse_chi = scratch.inverse_chi;
 
-    Vector<Real>& Su = Su_();
-    Vector<Real>& Sv = Sv_();
+    Vector<Real>& Su = scratch.Su;
+    Vector<Real>& Sv = scratch.Sv;
 
-    Vector<Real>& A         = A_        ();
-    Vector<Real>& C         = C_        ();
-    Vector<Real>& inverse_A = inverse_A_();
-    Vector<Real>& inverse_C = inverse_C_();
+    Vector<Real>& A         = scratch.A;
+    Vector<Real>& C         = scratch.C;
+    Vector<Real>& inverse_A = scratch.inverse_A;
+    Vector<Real>& inverse_C = scratch.inverse_C;
 
-    Vector<Real>& FF = FF_();
-    Vector<Real>& FI = FI_();
-    Vector<Real>& GG = GG_();
-    Vector<Real>& GI = GI_();
-    Vector<Real>& GP = GP_();
+    Vector<Real>& FF = scratch.FF;
+    Vector<Real>& FI = scratch.FI;
+    Vector<Real>& GG = scratch.GG;
+    Vector<Real>& GI = scratch.GI;
+    Vector<Real>& GP = scratch.GP;
 
-    Vector<Real>& L_diag  = L_diag_ ();
-    Matrix<Real>& L_upper = L_upper_();
-    Matrix<Real>& L_lower = L_lower_();
+    Vector<Real>& L_diag  = scratch.L_diag;
+    Matrix<Real>& L_upper = scratch.L_upper;
+    Matrix<Real>& L_lower = scratch.L_lower;
 
 
     // Get optical properties for first two elements
@@ -0,0 +1,167 @@
+#pragma once
+
+
+#include <algorithm>
+
+#include "tools/types.hpp"
+
+
+///  k-d tree over a set of points in 3D, for nearest-neighbour queries.
+///  The tree is stored implicitly in a permutation of the point indices: the
+///  middle element of each range [begin, end) is the node of that range, and
+///  the ranges before and after it are its subtrees, split along its axis.
+///////////////////////////////////////////////////////////////////////////////
+struct KdTree
+{
+    Double1 coords;   ///< coordinates of the points (3 per point)
+    Size1   index;    ///< permutation of the points, ordered as the tree
+    Size1   axis;     ///< splitting axis of the node at each position in index
+
+    ///  Builder for the tree
+    ///    @param[in] position : positions of the points
+    ////////////////////////////////////////////////////
+    inline void build (const Vector<Vector3D>& position)
+    {
+        const Size npoints = position.vec.size();
+
+        coords.resize (3*npoints);
+        index .resize (  npoints);
+        axis  .resize (  npoints);
+
+        for (Size p = 0; p < npoints; p++)
+        {
+            coords[3*p  ] = position.vec[p].x();
+            coords[3*p+1] = position.vec[p].y();
+            coords[3*p+2] = position.vec[p].z();
+
+            index[p] = p;
+        }
+
+        build (0, npoints);
+    }
+
+    ///  Getter for the k nearest points to a position
+    ///    @param[in]  x     : position (3 coordinates)
+    ///    @param[in]  k     : number of nearest points
+    ///    @param[out] nrs   : indices of the nearest points, closest first
+    ///    @param[out] dist2 : corresponding squared distances
+    //////////////////////////////////////////////////////////////////////
+    inline void get_nearest (
+        const double   x[3],
+        const Size     k,
+              Size1&   nrs,
+              Double1& dist2 ) const
+    {
+        nrs  .clear();
+        dist2.clear();
+
+        search (0, index.size(), x, k, nrs, dist2);
+    }
+
+    private:
+
+        inline void build (const Size begin, const Size end)
+        {
+            if (end - begin < 2) {return;}
+
+            // Split along the axis with the largest extent
+            double lo[3] = { 1.0e300,  1.0e300,  1.0e300};
+            double hi[3] = {-1.0e300, -1.0e300, -1.0e300};
+
+            for (Size i = begin; i < end; i++)
+            {
+                for (Size a = 0; a < 3; a++)
+                {
+                    lo[a] = std::min (lo[a], coords[3*index[i]+a]);
+                    hi[a] = std::max (hi[a], coords[3*index[i]+a]);
+                }
+            }
+
+            Size a_split = 0;
+
+            if (hi[1]-lo[1] > hi[a_split]-lo[a_split]) {a_split = 1;}
+            if (hi[2]-lo[2] > hi[a_split]-lo[a_split]) {a_split = 2;}
+
+            const Size middle = begin + (end - begin) / 2;
+
+            std::nth_element (index.begin()+begin, index.begin()+middle, index.begin()+end,
+                              [&] (const Size p1, const Size p2)
+                              {
+                                  return coords[3*p1+a_split] < coords[3*p2+a_split];
+                              });
+
+            axis[middle] = a_split;
+
+            build (begin,    middle);
+            build (middle+1, end   );
+        }
+
+        inline void search (
+            const Size     begin,
+            const Size     end,
+            const double   x[3],
+            const Size     k,
+                  Size1&   nrs,
+                  Double1& dist2 ) const
+        {
+            if (begin >= end) {return;}
+
+            const Size middle = begin + (end - begin) / 2;
+            const Size p      = index[middle];
+
+            const double dx = x[0] - coords[3*p  ];
+            const double dy = x[1] - coords[3*p+1];
+            const double dz = x[2] - coords[3*p+2];
+            const double d2 = dx*dx + dy*dy + dz*dz;
+
+            // Insert the node in the (sorted) list of the k nearest points
+            if ((nrs.size() < k) || (d2 < dist2.back()))
+            {
+                if (nrs.size() == k)
+                {
+                    nrs  .pop_back();
+                    dist2.pop_back();
+                }
+
+                Size i = nrs.size();
+
+                nrs  .push_back (p);
+                dist2.push_back (d2);
+
+                while ((i > 0) && (dist2[i-1] > d2))
+                {
+                    nrs  [i] = nrs  [i-1];
+                    dist2[i] = dist2[i-1];
+
+                    i--;
+                }
+
+                nrs  [i] = p;
+                dist2[i] = d2;
+            }
+
+            if (end - begin < 2) {return;}
+
+            const double diff = x[axis[middle]] - coords[3*p+axis[middle]];
+
+            // First search the side of the split containing x
+            if (diff < 0.0)
+            {
+                search (begin, middle, x, k, nrs, dist2);
+
+                if ((nrs.size() < k) || (diff*diff < dist2.back()))
+                {
+                    search (middle+1, end, x, k, nrs, dist2);
+                }
+            }
+            else
+            {
+                search (middle+1, end, x, k, nrs, dist2);
+
+                if ((nrs.size() < k) || (diff*diff < dist2.back()))
+                {
+                    search (begin, middle, x, k, nrs, dist2);
+                }
+            }
+        }
+};
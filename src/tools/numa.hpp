@@ -0,0 +1,140 @@
+#pragma once
+
+
+#include <stdexcept>
+#include "tools/types.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+
+///  Give the pages that lie entirely inside an array back to the kernel, such
+///  that they are placed again (zero-filled) by the first thread touching them.
+///    @param[in] ptr   : pointer to the start of the array
+///    @param[in] bytes : size of the array in bytes
+///////////////////////////////////////////////////////////////////////////////
+inline void release_pages (void* ptr, const size_t bytes)
+{
+#ifdef __linux__
+    const size_t page  = sysconf (_SC_PAGESIZE);
+    const size_t begin = (reinterpret_cast<size_t>(ptr) + page - 1) / page * page;
+    const size_t end   = (reinterpret_cast<size_t>(ptr) + bytes   ) / page * page;
+
+    if (end > begin)
+    {
+        madvise (reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+#endif
+}
+
+
+///  Place the memory of a point-indexed array with the threads that work on
+///  those points, using the same partition of the points as threaded_for.
+///  The array is assumed to be laid out as [nouter][npoints][ninner]. Its
+///  content is preserved (via a temporary copy, so it briefly needs twice the
+///  memory of the array).
+///    @param[in,out] v       : array to place
+///    @param[in]     nouter  : number of blocks before the point index
+///    @param[in]     npoints : number of points
+///    @param[in]     ninner  : number of elements per point
+///////////////////////////////////////////////////////////////////////////////
+template <typename type>
+inline void first_touch (Vector<type>& v, const Size nouter, const Size npoints, const Size ninner)
+{
+    if (v.vec.size() != (size_t) nouter*npoints*ninner)
+    {
+        throw std::runtime_error ("first_touch: array size does not match its dimensions.");
+    }
+
+    if (v.vec.empty()) {return;}
+
+    const vector<type> copy = v.vec;
+
+    release_pages (v.vec.data(), v.vec.size()*sizeof(type));
+
+    type* data = v.vec.data();
+
+    threaded_for (p, npoints,
+    {
+        for (Size o = 0; o < nouter; o++)
+        {
+            const size_t offset = ((size_t) o*npoints + p)*ninner;
+
+            for (Size i = 0; i < ninner; i++)
+            {
+                data[offset+i] = copy[offset+i];
+            }
+        }
+    })
+}
+
+
+///  Pin the threads of the multi-threading layer to the cores of the process
+///    @param[in] policy : "none"   : let every thread run on all cores,
+///                        "close"  : thread t on the t'th core,
+///                        "spread" : threads evenly spread over the cores
+///    @return number of threads that was pinned
+///////////////////////////////////////////////////////////////////////////////
+inline Size set_thread_affinity (const string& policy)
+{
+    if ((policy != "none") && (policy != "close") && (policy != "spread"))
+    {
+        throw std::runtime_error ("Unknown thread affinity policy: " + policy);
+    }
+
+    Size n_pinned = 0;
+
+#ifdef __linux__
+    // Cores on which the process is allowed to run, as found the first time
+    static cpu_set_t allowed;
+    static bool      allowed_set = false;
+
+    if (!allowed_set)
+    {
+        CPU_ZERO (&allowed);
+        sched_getaffinity (0, sizeof(cpu_set_t), &allowed);
+        allowed_set = true;
+    }
+
+    Size1 cores;
+
+    for (Size c = 0; c < CPU_SETSIZE; c++)
+    {
+        if (CPU_ISSET (c, &allowed)) {cores.push_back (c);}
+    }
+
+    const Size ncores   = cores.size();
+    const Size nthreads = paracabs::multi_threading::n_threads_avail();
+
+    Char1 pinned (nthreads, false);
+
+    // With as many iterations as threads, threaded_for gives each thread one
+    threaded_for (t, nthreads,
+    {
+        cpu_set_t mask = allowed;
+
+        if (policy != "none")
+        {
+            const Size c = (policy == "close") ? t % ncores
+                                               : ((t % ncores) * ncores) / std::min (nthreads, ncores);
+            CPU_ZERO (&mask);
+            CPU_SET  (cores[c], &mask);
+        }
+
+        if (sched_setaffinity (0, sizeof(cpu_set_t), &mask) == 0)
+        {
+            pinned[t] = (policy != "none");
+        }
+    })
+
+    for (Size t = 0; t < nthreads; t++)
+    {
+        if (pinned[t]) {n_pinned++;}
+    }
+#endif
+
+    return n_pinned;
+}
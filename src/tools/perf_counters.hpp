@@ -0,0 +1,320 @@
+#pragma once
+
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+#include "tools/types.hpp"
+
+#if (PERF_COUNTERS) && defined(__linux__)
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+///  Phases of the solver for which the hardware performance counters are kept.
+///  get_eta_and_chi is inlined in the per-frequency kernels, so it is counted
+///  as part of the Feautrier phase.
+///////////////////////////////////////////////////////////////////////////////
+enum PerfPhase : Size
+{
+    PERF_TRACE_RAY,        ///< ray tracing (trace_ray)
+    PERF_FEAUTRIER,        ///< emissivities, opacities and Feautrier solves along a ray pair
+    PERF_RATE_EQUATIONS,   ///< solve of the (global) rate equations of a species
+    PERF_NPHASES
+};
+
+
+///  Hardware performance counters of a single thread: cycles, instructions and
+///  last level cache references and misses, accumulated per phase, together
+///  with the wall-clock time and the number of calls.
+///////////////////////////////////////////////////////////////////////////////
+struct PerfThread
+{
+    static const Size nevents = 4;
+
+    int  fd[nevents] = {-1, -1, -1, -1};   ///< file descriptors of the counter group (leader first)
+    long tid         = -1;                 ///< (kernel) id of the thread that opened the counters
+
+    uint64_t counts[PERF_NPHASES][nevents] = {};   ///< accumulated counts
+    double   time  [PERF_NPHASES]          = {};   ///< accumulated wall-clock time [s]
+    uint64_t calls [PERF_NPHASES]          = {};   ///< number of measured sections
+
+    ///  Open the counters for the calling thread (if not done yet by this thread)
+    ///    @return true if the counters are available
+    /////////////////////////////////////////////////////////////////////////////
+    inline bool open ()
+    {
+#if (PERF_COUNTERS) && defined(__linux__)
+        const long self = syscall (SYS_gettid);
+
+        if (tid == self) {return (fd[0] >= 0);}
+
+        close();
+
+        tid = self;
+
+        const uint64_t configs[nevents] = {PERF_COUNT_HW_CPU_CYCLES,
+                                           PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CACHE_REFERENCES,
+                                           PERF_COUNT_HW_CACHE_MISSES     };
+
+        for (Size e = 0; e < nevents; e++)
+        {
+            struct perf_event_attr attr;
+            memset (&attr, 0, sizeof(attr));
+
+            attr.size           = sizeof(attr);
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.config         = configs[e];
+            attr.disabled       = (e == 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP
+                                | PERF_FORMAT_TOTAL_TIME_ENABLED
+                                | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // Only the calling thread (pid = 0), on any cpu (-1)
+            fd[e] = syscall (SYS_perf_event_open, &attr, 0, -1, fd[0], 0);
+
+            if (fd[e] < 0)
+            {
+                close();
+                tid = self;
+                return false;
+            }
+        }
+
+        ioctl (fd[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+        ioctl (fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    ///  Close the counters
+    ///////////////////////
+    inline void close ()
+    {
+#if (PERF_COUNTERS) && defined(__linux__)
+        for (Size e = 0; e < nevents; e++)
+        {
+            if (fd[e] >= 0) {::close (fd[e]);}
+
+            fd[e] = -1;
+        }
+#endif
+        tid = -1;
+    }
+
+    ///  Getter for the current values of the counters (scaled for multiplexing)
+    ///    @param[out] values : current values of the counters (0 if unavailable)
+    /////////////////////////////////////////////////////////////////////////////
+    inline void read (uint64_t values[nevents]) const
+    {
+        for (Size e = 0; e < nevents; e++) {values[e] = 0;}
+
+#if (PERF_COUNTERS) && defined(__linux__)
+        if (fd[0] < 0) {return;}
+
+        // nr, time_enabled, time_running, values
+        uint64_t buffer[3+nevents];
+
+        if (::read (fd[0], buffer, sizeof(buffer)) != (ssize_t) sizeof(buffer)) {return;}
+
+        const double scale = (buffer[2] > 0) ? (double) buffer[1] / buffer[2] : 0.0;
+
+        for (Size e = 0; e < nevents; e++)
+        {
+            values[e] = (uint64_t) (buffer[3+e] * scale);
+        }
+#endif
+    }
+
+    ~PerfThread () {close();}
+};
+
+
+///  Getter for the counters of all threads (Meyers' singleton)
+///    @return counters of all threads
+//////////////////////////////////////////////////////////////
+inline pc::multi_threading::ThreadPrivate<PerfThread>& perf_threads ()
+{
+    static pc::multi_threading::ThreadPrivate<PerfThread> threads;
+
+    return threads;
+}
+
+
+///  Section of code measured with the performance counters of the calling thread
+///  (from construction to destruction). Use through PERF_SCOPE, such that it is
+///  compiled away when Magritte is not built with PERF_COUNTERS.
+/////////////////////////////////////////////////////////////////////////////////
+class PerfScope
+{
+    private:
+        const PerfPhase phase;
+        PerfThread&     thread;
+        uint64_t        start[PerfThread::nevents];
+
+        std::chrono::high_resolution_clock::time_point start_time;
+
+    public:
+        inline PerfScope (const PerfPhase p): phase (p), thread (perf_threads()())
+        {
+            thread.open ();
+            thread.read (start);
+
+            start_time = std::chrono::high_resolution_clock::now();
+        }
+
+        inline ~PerfScope ()
+        {
+            const std::chrono::duration<double> interval = std::chrono::high_resolution_clock::now() - start_time;
+
+            uint64_t stop[PerfThread::nevents];
+            thread.read (stop);
+
+            for (Size e = 0; e < PerfThread::nevents; e++)
+            {
+                thread.counts[phase][e] += stop[e] - start[e];
+            }
+
+            thread.time [phase] += interval.count();
+            thread.calls[phase] += 1;
+        }
+};
+
+
+#if (PERF_COUNTERS) && !(GPU_ACCELERATION)
+#   define PERF_SCOPE(phase) PerfScope perf_scope (phase)
+#else
+#   define PERF_SCOPE(phase)
+#endif
+
+
+///  Getter for whether Magritte was built with the performance counters
+///    @return true if built with PERF_COUNTERS
+//////////////////////////////////////////////////////////////////////////
+inline bool perf_counters_enabled ()
+{
+#if (PERF_COUNTERS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+///  Reset the accumulated counts of all threads
+////////////////////////////////////////////////
+inline void reset_perf_counters ()
+{
+    pc::multi_threading::ThreadPrivate<PerfThread>& threads = perf_threads();
+
+    for (Size t = 0; t < threads.contents.size(); t++)
+    {
+        PerfThread& thread = threads(t);
+
+        for (Size ph = 0; ph < PERF_NPHASES; ph++)
+        {
+            for (Size e = 0; e < PerfThread::nevents; e++) {thread.counts[ph][e] = 0;}
+
+            thread.time [ph] = 0.0;
+            thread.calls[ph] = 0;
+        }
+    }
+}
+
+
+///  Getter for the report of the performance counters, per phase summed over
+///  the threads (and per thread if requested), in the format of the Timer. The
+///  memory bandwidth is estimated from the last level cache misses (64 bytes
+///  per miss), since the memory controller counters are not portable.
+///    @param[in] per_thread : also report the counts of each thread
+///    @return report
+///////////////////////////////////////////////////////////////////////////////
+inline string get_perf_report_string (const bool per_thread = false)
+{
+    const char* names[PERF_NPHASES] = {"trace_ray", "feautrier", "rate_equations"};
+
+    pc::multi_threading::ThreadPrivate<PerfThread>& threads = perf_threads();
+
+    // The counters can be unavailable (e.g. in a virtual machine), then only times are reported
+    bool available = false;
+
+    for (Size t = 0; t < threads.contents.size(); t++)
+    {
+        available = available || (threads(t).fd[0] >= 0);
+    }
+
+    std::ostringstream report;
+
+    auto add_line = [&] (const string& name, const uint64_t counts[PerfThread::nevents], const double time, const uint64_t calls)
+    {
+        report << "P   | " << std::left << std::setw(20) << name << std::right
+               << " : " << std::setw(10) << calls << " calls, "
+               << std::fixed << std::setprecision(6) << time << " seconds";
+
+        if (available)
+        {
+            const double ipc       = (counts[0] > 0) ? (double) counts[1] / counts[0] : 0.0;
+            const double miss_rate = (counts[2] > 0) ? (double) counts[3] / counts[2] : 0.0;
+            const double bandwidth = (time      > 0) ? 64.0 * counts[3] / time * 1.0e-9 : 0.0;
+
+            report << ", " << counts[0] << " cycles, " << counts[1] << " instructions, "
+                   << std::setprecision(2) << ipc << " IPC, "
+                   << counts[3] << " / " << counts[2] << " LLC misses (" << 100.0*miss_rate << " %), "
+                   << bandwidth << " GB/s (est.)";
+        }
+
+        report << std::endl;
+    };
+
+    if (perf_counters_enabled() && !available)
+    {
+        report << "P   | hardware counters unavailable, only times are reported" << std::endl;
+    }
+
+    for (Size ph = 0; ph < PERF_NPHASES; ph++)
+    {
+        uint64_t counts[PerfThread::nevents] = {};
+        double   time                        = 0.0;
+        uint64_t calls                       = 0;
+
+        for (Size t = 0; t < threads.contents.size(); t++)
+        {
+            for (Size e = 0; e < PerfThread::nevents; e++) {counts[e] += threads(t).counts[ph][e];}
+
+            time  += threads(t).time [ph];
+            calls += threads(t).calls[ph];
+        }
+
+        add_line (names[ph], counts, time, calls);
+
+        if (per_thread)
+        {
+            for (Size t = 0; t < threads.contents.size(); t++)
+            {
+                add_line ("  thread " + to_string (t), threads(t).counts[ph], threads(t).time[ph], threads(t).calls[ph]);
+            }
+        }
+    }
+
+    return report.str();
+}
+
+
+///  Print the report of the performance counters to screen
+///    @param[in] per_thread : also report the counts of each thread
+//////////////////////////////////////////////////////////////////
+inline void print_perf_report (const bool per_thread = false)
+{
+    cout << get_perf_report_string (per_thread);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+
+#include "tools/types.hpp"
+
+
+///  Pairwise (cascade) summation of the elements [begin, end) of a vector.
+///  The order of the additions only depends on the number of elements, so
+///  the result is the same for any number of threads that filled the vector,
+///  and the rounding error only grows as log(n).
+///    @param[in] x     : vector to sum
+///    @param[in] begin : index of the first element
+///    @param[in] end   : index one past the last element
+///    @return sum of the elements
+//////////////////////////////////////////////////////////////////////////////
+template <typename type>
+inline type pairwise_sum (const vector<type>& x, const size_t begin, const size_t end)
+{
+    if (end - begin <= 8)
+    {
+        type sum = 0.0;
+
+        for (size_t i = begin; i < end; i++)
+        {
+            sum += x[i];
+        }
+
+        return sum;
+    }
+
+    const size_t middle = begin + (end - begin) / 2;
+
+    return pairwise_sum (x, begin, middle) + pairwise_sum (x, middle, end);
+}
+
+
+///  Pairwise summation of all elements of a vector
+///    @param[in] x : vector to sum
+///    @return sum of the elements
+///////////////////////////////////////////////////
+template <typename type>
+inline type pairwise_sum (const vector<type>& x)
+{
+    return pairwise_sum (x, 0, x.size());
+}
@@ -11,10 +11,13 @@ using std::list;
 #include <string>
 using std::string;
 using std::to_string;
+#include <limits>
+#include <stdexcept>
 #include <Eigen/Core>
 using Eigen::VectorXd;
 using Eigen::MatrixXd;
 
+#include "../configure.hpp"
 #include "paracabs.hpp"
 namespace pc = paracabs;
 
@@ -22,6 +25,14 @@ namespace pc = paracabs;
 typedef long double Real;
 typedef uint32_t   Size;
 
+// Flat indices combining a point with a level, line, transition or frequency
+// (e.g. p*nlev+i) can exceed the range of Size in very large models
+#if LARGE_INDICES
+    typedef uint64_t Index;
+#else
+    typedef Size     Index;
+#endif
+
 using Vector3D = pc::datatypes::Vector3D <double>;
 
 template <typename type>
@@ -32,6 +43,23 @@ template <typename type>
 using Tensor = pc::datatypes::Tensor <type>;
 
 
+///  Checks (at setup time) whether flat indices over n1 x n2 elements fit in
+///  an Index, since products of Size indices silently overflow otherwise
+///    @param[in] name : description of the indexed data (for the error message)
+///    @param[in] n1   : number of elements in the outer dimension
+///    @param[in] n2   : number of elements in the inner dimension
+//////////////////////////////////////////////////////////////////////////////
+inline void check_index_range (const string name, const uint64_t n1, const uint64_t n2)
+{
+    if ((n2 > 0) && (n1 > std::numeric_limits<Index>::max() / n2))
+    {
+        throw std::runtime_error (
+            "Too many elements in " + name + " (" + to_string (n1) + " x " + to_string (n2)
+            + ") for " + to_string (8*sizeof(Index)) + "-bit indices, rebuild with -DLARGE_INDICES=ON.");
+    }
+}
+
+
 const Real one  = 1.0;
 const Real two  = 2.0;
 const Real half = 0.5;
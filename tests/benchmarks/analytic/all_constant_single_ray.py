@@ -51,7 +51,7 @@ def create_model ():
     model.geometry.points.position.set([[i*dx, 0, 0] for i in range(npoints)])
     model.geometry.points.velocity.set([[i*dv, 0, 0] for i in range(npoints)])
 
-    model.chemistry.species.abundance = [[     0.0,    nTT,  nH2,  0.0,      1.0] for _ in range(npoints)]
+    model.chemistry.species.abundance.set([[     0.0,    nTT,  nH2,  0.0,      1.0] for _ in range(npoints)])
     model.chemistry.species.symbol    =  ['dummy0', 'test', 'H2', 'e-', 'dummy1']
 
     model.thermodynamics.temperature.gas  .set( temp                 * np.ones(npoints))
@@ -99,6 +99,12 @@ def run_model (nosave=False):
     timer4.stop()
     u_2f = np.array(model.radiation.u)
 
+    timer5 = tools.Timer('feautrier 4  ')
+    timer5.start()
+    model.compute_radiation_field_feautrier_order_4 ()
+    timer5.stop()
+    u_4f = np.array(model.radiation.u)
+
     x  = np.array(model.geometry.points.position)[:,0]
     nu = np.array(model.radiation.frequencies.nu)
 
@@ -125,6 +131,7 @@ def run_model (nosave=False):
 
     error_u_0s = tools.relative_error (u_(x), u_0s[0,:,0])
     error_u_2f = tools.relative_error (u_(x), u_2f[0,:,0])
+    error_u_4f = tools.relative_error (u_(x), u_4f[0,:,0])
 
     result  = f'--- Benchmark name ----------------------------\n'
     result += f'{modelName                                    }\n'
@@ -136,11 +143,13 @@ def run_model (nosave=False):
     result += f'--- Accuracy ----------------------------------\n'
     result += f'max error in shortchar 0 = {np.max(error_u_0s)}\n'
     result += f'max error in feautrier 2 = {np.max(error_u_2f)}\n'
+    result += f'max error in feautrier 4 = {np.max(error_u_4f)}\n'
     result += f'--- Timers ------------------------------------\n'
     result += f'{timer1.print()                               }\n'
     result += f'{timer2.print()                               }\n'
     result += f'{timer3.print()                               }\n'
     result += f'{timer4.print()                               }\n'
+    result += f'{timer5.print()                               }\n'
     result += f'-----------------------------------------------\n'
 
     print(result)
@@ -153,6 +162,7 @@ def run_model (nosave=False):
         plt.title(modelName)
         plt.scatter(x, u_0s[0,:,0], s=0.5, label='0s', zorder=1)
         plt.scatter(x, u_2f[0,:,0], s=0.5, label='2f', zorder=1)
+        plt.scatter(x, u_4f[0,:,0], s=0.5, label='4f', zorder=1)
         plt.plot(x, u_(x), c='lightgray', zorder=0)
         plt.legend()
         plt.xscale('log')
@@ -55,7 +55,7 @@ def create_model ():
     model.geometry.points.position.set([[(i+1)*dx, 0, 0] for i in range(npoints)])
     model.geometry.points.velocity.set([[(i+1)*dv, 0, 0] for i in range(npoints)])
 
-    model.chemistry.species.abundance = [[     0.0,    nTT,  nH2,  0.0,      1.0] for _ in range(npoints)]
+    model.chemistry.species.abundance.set([[     0.0,    nTT,  nH2,  0.0,      1.0] for _ in range(npoints)])
     model.chemistry.species.symbol    =  ['dummy0', 'test', 'H2', 'e-', 'dummy1']
 
     model.thermodynamics.temperature.gas  .set( temp                 * np.ones(npoints))
@@ -0,0 +1,177 @@
+import os
+import sys
+
+curdir = os.path.dirname(os.path.realpath(__file__))
+datdir = f'{curdir}/../../data/'
+moddir = f'{curdir}/../../models/'
+resdir = f'{curdir}/../../results/'
+
+import numpy             as np
+import matplotlib.pyplot as plt
+import magritte.tools    as tools
+import magritte.core     as magritte
+
+import all_constant_single_ray         as all_constant
+import density_distribution_single_ray as density_distribution
+
+
+npoints_list = [25, 50, 100, 200, 400]
+
+length = 4.9E+13   # [m] extent of the all_constant model
+
+
+def u_all_constant (model):
+    """
+    Analytic solution of the all_constant benchmark, single ray.
+    """
+
+    ld = model.lines.lineProducingSpecies[0].linedata
+
+    k = 0
+
+    temp = all_constant.temp
+    turb = all_constant.turb
+
+    frq = ld.frequency[k]
+    pop = tools.LTEpop         (ld, temp) * all_constant.nTT
+    phi = tools.profile        (ld, k, temp, (turb/magritte.CC)**2, frq)
+    chi = tools.lineOpacity    (ld, pop)[k] * phi
+    src = tools.lineSource     (ld, pop)[k]
+    bdy = tools.I_CMB          (frq)
+
+    x = np.array(model.geometry.points.position)[:,0]
+
+    I_0 = src + (bdy-src)*np.exp(-chi*x)
+    I_1 = src + (bdy-src)*np.exp(-chi*(x[-1]-x))
+
+    return 0.5 * (I_0 + I_1)
+
+
+def u_density_distribution (model):
+    """
+    Analytic solution of the density distribution benchmark (b), single ray.
+    """
+
+    ld = model.lines.lineProducingSpecies[0].linedata
+
+    k = 0
+
+    temp  = density_distribution.temp
+    turb  = density_distribution.turb
+    r_in  = density_distribution.r_in
+    r_out = density_distribution.r_out
+    X_mol = density_distribution.get_X_mol['b']
+
+    frq = ld.frequency[k]
+    pop = tools.LTEpop         (ld, temp) * X_mol * density_distribution.nH2_in
+    phi = tools.profile        (ld, k, temp, (turb/magritte.CC)**2, frq)
+    chi = tools.lineOpacity    (ld, pop)[k] * phi
+    src = tools.lineSource     (ld, pop)[k]
+    bdy = tools.I_CMB          (frq)
+
+    x = np.array(model.geometry.points.position)[:,0]
+
+    I_0 = src + (bdy-src)*np.exp(-chi*r_in*(1.0    - r_in/x    ))
+    I_1 = src + (bdy-src)*np.exp(-chi*r_in*(r_in/x - r_in/r_out))
+
+    return 0.5 * (I_0 + I_1)
+
+
+def get_errors (modelName, u_analytic):
+    """
+    Maximum relative error in u of the 2nd and 4th-order Feautrier solvers.
+    """
+
+    model = magritte.Model (f'{moddir}{modelName}.hdf5')
+    model.compute_spectral_discretisation ()
+    model.compute_inverse_line_widths     ()
+    model.compute_LTE_level_populations   ()
+
+    model.compute_radiation_field_feautrier_order_2 ()
+    u_2f = np.array(model.radiation.u)
+
+    model.compute_radiation_field_feautrier_order_4 ()
+    u_4f = np.array(model.radiation.u)
+
+    u = u_analytic (model)
+
+    error_u_2f = np.max(tools.relative_error (u, u_2f[0,:,0]))
+    error_u_4f = np.max(tools.relative_error (u, u_4f[0,:,0]))
+
+    return (error_u_2f, error_u_4f)
+
+
+def get_order (npoints, errors):
+    """
+    Empirical order of convergence between successive refinements.
+    """
+    return np.log(errors[:-1]/errors[1:]) / np.log(npoints[1:]/npoints[:-1])
+
+
+def run_test (nosave=False):
+
+    timestamp = tools.timestamp()
+
+    benchmarks = {}
+
+    # all_constant: same extent, increasingly finer spacing
+    errors = []
+    for n in npoints_list:
+        all_constant.npoints = n
+        all_constant.dx      = length / (n-1)
+        all_constant.create_model ()
+        errors.append (get_errors ('all_constant_single_ray', u_all_constant))
+    benchmarks['all_constant_single_ray'] = np.array(errors)
+
+    # density distribution (b): logarithmically spaced radii
+    errors = []
+    for n in npoints_list:
+        density_distribution.npoints = n
+        density_distribution.rs      = np.logspace (np.log10(density_distribution.r_in ),
+                                                    np.log10(density_distribution.r_out),
+                                                    n, endpoint=True                     )
+        density_distribution.create_model ('b')
+        errors.append (get_errors ('density_distribution_VZb_single_ray', u_density_distribution))
+    benchmarks['density_distribution_VZb_single_ray'] = np.array(errors)
+
+    npoints = np.array(npoints_list, dtype=float)
+
+    result  = f'--- Benchmark name ----------------------------\n'
+    result += f'convergence_order_single_ray                   \n'
+    for name, errors in benchmarks.items():
+        order_2f = get_order (npoints, errors[:,0])
+        order_4f = get_order (npoints, errors[:,1])
+        result += f'--- {name} \n'
+        result += f'npoints   max error 2f   max error 4f   order 2f   order 4f\n'
+        for i, n in enumerate(npoints_list):
+            o_2f = f'{order_2f[i-1]:8.2f}' if (i > 0) else f'{"":8}'
+            o_4f = f'{order_4f[i-1]:8.2f}' if (i > 0) else f'{"":8}'
+            result += f'{n:7d}   {errors[i,0]:.6e}   {errors[i,1]:.6e}   {o_2f}   {o_4f}\n'
+    result += f'-----------------------------------------------\n'
+
+    print(result)
+
+    if not nosave:
+        with open(f'{resdir}convergence_order_single_ray-{timestamp}.log' ,'w') as log:
+            log.write(result)
+
+        plt.figure(dpi=150)
+        plt.title('convergence_order_single_ray')
+        for name, errors in benchmarks.items():
+            plt.plot(npoints, errors[:,0], marker='o', label=f'{name} (2f)')
+            plt.plot(npoints, errors[:,1], marker='s', label=f'{name} (4f)')
+        plt.legend(fontsize=6)
+        plt.xscale('log')
+        plt.yscale('log')
+        plt.xlabel('npoints')
+        plt.ylabel('max relative error in u')
+        plt.savefig(f'{resdir}convergence_order_single_ray-{timestamp}.png', dpi=150)
+
+    return
+
+
+if __name__ == '__main__':
+
+    nosave = (len(sys.argv) > 1) and (sys.argv[1] == 'nosave')
+
+    run_test (nosave)
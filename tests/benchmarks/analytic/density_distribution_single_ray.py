@@ -64,7 +64,7 @@ def create_model (a_or_b):
     model.geometry.points.position.set([[r, 0, 0] for r in rs])
     model.geometry.points.velocity.set([[0, 0, 0] for i in range(npoints)])
 
-    model.chemistry.species.abundance = [[     0.0, nTT(r), nH2(r),  0.0,      1.0] for r in rs]
+    model.chemistry.species.abundance.set([[     0.0, nTT(r), nH2(r),  0.0,      1.0] for r in rs])
     model.chemistry.species.symbol    =  ['dummy0', 'test',   'H2', 'e-', 'dummy1']
 
     model.thermodynamics.temperature.gas  .set( temp                 * np.ones(npoints))
@@ -114,6 +114,12 @@ def run_model (a_or_b, nosave=False):
     timer4.stop()
     u_2f = np.array(model.radiation.u)
 
+    timer5 = tools.Timer('feautrier 4  ')
+    timer5.start()
+    model.compute_radiation_field_feautrier_order_4 ()
+    timer5.stop()
+    u_4f = np.array(model.radiation.u)
+
     x  = np.array(model.geometry.points.position)[:,0]
     nu = np.array(model.radiation.frequencies.nu)
 
@@ -140,6 +146,7 @@ def run_model (a_or_b, nosave=False):
 
     error_u_0s = tools.relative_error (u_(x), u_0s[0,:,0])
     error_u_2f = tools.relative_error (u_(x), u_2f[0,:,0])
+    error_u_4f = tools.relative_error (u_(x), u_4f[0,:,0])
 
     result  = f'--- Benchmark name ----------------------------\n'
     result += f'{modelName                                    }\n'
@@ -151,11 +158,13 @@ def run_model (a_or_b, nosave=False):
     result += f'--- Accuracy ----------------------------------\n'
     result += f'max error in shortchar 0 = {np.max(error_u_0s)}\n'
     result += f'max error in feautrier 2 = {np.max(error_u_2f)}\n'
+    result += f'max error in feautrier 4 = {np.max(error_u_4f)}\n'
     result += f'--- Timers ------------------------------------\n'
     result += f'{timer1.print()                               }\n'
     result += f'{timer2.print()                               }\n'
     result += f'{timer3.print()                               }\n'
     result += f'{timer4.print()                               }\n'
+    result += f'{timer5.print()                               }\n'
     result += f'-----------------------------------------------\n'
 
     print(result)
@@ -168,6 +177,7 @@ def run_model (a_or_b, nosave=False):
         plt.title(modelName)
         plt.scatter(x, u_0s[0,:,0], s=0.5, label='0s', zorder=1)
         plt.scatter(x, u_2f[0,:,0], s=0.5, label='2f', zorder=1)
+        plt.scatter(x, u_4f[0,:,0], s=0.5, label='4f', zorder=1)
         plt.plot(x, u_(x), c='lightgray', zorder=0)
         plt.legend()
         plt.xscale('log')
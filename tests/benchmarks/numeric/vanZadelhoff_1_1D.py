@@ -68,7 +68,7 @@ def create_model (a_or_b):
     model.geometry.points.position.set([[r, 0, 0] for r in rs])
     model.geometry.points.velocity.set(np.zeros((npoints, 3)))
 
-    model.chemistry.species.abundance = [[     0.0, nTT(r), nH2(r),  0.0,      1.0] for r in rs]
+    model.chemistry.species.abundance.set([[     0.0, nTT(r), nH2(r),  0.0,      1.0] for r in rs])
     model.chemistry.species.symbol    =  ['dummy0', 'test',   'H2', 'e-', 'dummy1']
 
     model.thermodynamics.temperature.gas  .set( temp                 * np.ones(npoints))
@@ -64,7 +64,7 @@ def create_model (a_or_b):
     model.geometry.points.position.set([[r, 0, 0] for r in rs])
     model.geometry.points.velocity.set([[v, 0, 0] for v in vs])
 
-    model.chemistry.species.abundance = [[     0.0,  x*n,      n,  0.0,      1.0] for (x,n) in zip(X_mol, nH2)]
+    model.chemistry.species.abundance.set([[     0.0,  x*n,      n,  0.0,      1.0] for (x,n) in zip(X_mol, nH2)])
     model.chemistry.species.symbol    =  ['dummy0', 'HCO+', 'H2', 'e-', 'dummy1']
 
     model.thermodynamics.temperature.gas  .set(temp   )
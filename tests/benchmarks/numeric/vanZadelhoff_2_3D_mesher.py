@@ -107,7 +107,7 @@ def create_model (a_or_b):
 #     model.geometry.points.  neighbors.set(  nbs)
 #     model.geometry.points.n_neighbors.set(n_nbs)
 
-    model.chemistry.species.abundance = [[     0.0, X_mol_int(r)*nH2_int(r), nH2_int(r),  0.0,      1.0] for r in rs]
+    model.chemistry.species.abundance.set([[     0.0, X_mol_int(r)*nH2_int(r), nH2_int(r),  0.0,      1.0] for r in rs])
     model.chemistry.species.symbol    =  ['dummy0',                  'HCO+',       'H2', 'e-', 'dummy1']
 
     model.thermodynamics.temperature.gas  .set([temp_int(r)    for r in rs])
@@ -8,6 +8,25 @@ cd $DIR
 # Create a directory to store the results
 mkdir results
 
+# Directory with the test executables (see build.sh)
+BIN=$DIR/../build/tests
+# Models created by the integration tests
+MOD=$DIR/models
+
+# Number of failed tests
+FAILED=0
+
+# Run a test executable (logging to results/), and count it if it fails
+run_test ()
+{
+    echo "  $@"
+    if ! $BIN/"$@" > $DIR/results/$1.log 2>&1
+    then
+        echo "    FAILED (see results/$1.log)"
+        FAILED=$((FAILED+1))
+    fi
+}
+
 # Unit tests
 echo "Running unit tests..."
 
@@ -17,6 +36,28 @@ echo "Running integration tests..."
 cd $DIR/benchmarks/analytic
 python all_constant_single_ray.py         nosave
 python density_distribution_single_ray.py nosave
+python convergence_order_single_ray.py    nosave
 
 cd $DIR/benchmarks/numeric
 python vanZadelhoff_1_1D.py               nosave
+
+# Tests of the core (on the models of the integration tests). Not included are
+# test_successor_graph and test_adaptive_rays, since they need a (nearly)
+# regular grid and nested HEALPix rays respectively, and the timing tests.
+echo "Running core tests..."
+
+cd $DIR
+
+run_test test_model_read        $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_reproducibility   $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_first_touch       $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_perf_counters     $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_lambda_pruning    $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_tune_parameters   $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_feautrier_order_4 $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_incremental       $MOD/vanZadelhoff_1a_1D.hdf5
+run_test test_warm_start        $MOD/vanZadelhoff_1a_1D.hdf5 $MOD/vanZadelhoff_1a_1D.hdf5
+
+echo "$FAILED core test(s) failed."
+
+exit $FAILED
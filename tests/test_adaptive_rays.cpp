@@ -0,0 +1,79 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+    const double tolerance = (argc > 2) ? atof (argv[2]) : -1.0;
+
+    cout << "Running test_adaptive_rays..."                          << endl;
+    cout << "-----------------------------"                          << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    Model model (modelName);
+
+    if (tolerance > 0.0)
+    {
+        model.parameters.ray_tolerance = tolerance;
+    }
+
+    cout << "ray tolerance = " << model.parameters.ray_tolerance << endl;
+
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+
+    Timer timer_full("solver: all rays");
+    timer_full.start();
+    model.compute_radiation_field_feautrier_order_2 ();
+    timer_full.stop();
+    timer_full.print();
+
+    const vector<Real> J_full = model.radiation.J.vec;
+
+    Timer timer_select("adaptive rays: selection");
+    timer_select.start();
+    model.compute_adaptive_rays ();
+    timer_select.stop();
+    timer_select.print();
+
+    Timer timer_adaptive("solver: adaptive rays");
+    timer_adaptive.start();
+    model.compute_radiation_field_feautrier_order_2 ();
+    timer_adaptive.stop();
+    timer_adaptive.print();
+
+    const vector<Real> J_adaptive = model.radiation.J.vec;
+
+    double J_diff_mean = 0.0;
+    double J_diff_max  = 0.0;
+
+    for (Size i = 0; i < J_full.size(); i++)
+    {
+        const double J_diff = fabs (J_adaptive[i] - J_full[i]) / J_full[i];
+
+        J_diff_mean += J_diff;
+        J_diff_max   = std::max (J_diff_max, J_diff);
+    }
+
+    cout << "rel. diff. J : mean = " << J_diff_mean / J_full.size()
+                      << "   max = " << J_diff_max                  << endl;
+
+    // Refinement aims to keep u, and hence J (a weighted mean of u), within the tolerance
+    if (J_diff_max > model.parameters.ray_tolerance)
+    {
+        cout << "Adaptive J differs by more than the ray tolerance!" << endl;
+
+        return (1);
+    }
+
+    cout << "Done." << endl;
+
+    return (0);
+}
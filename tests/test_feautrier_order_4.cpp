@@ -0,0 +1,131 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+///  Mean intensities of a model, with the 2nd- and 4th-order Feautrier solver
+///    @param[in]  modelName : name of the model
+///    @param[out] J_order_2 : mean intensity (2nd order)
+///    @param[out] J_order_4 : mean intensity (4th order)
+///    @return number of frequencies
+////////////////////////////////////////////////////////////////////////////////
+Size compute_J (const string& modelName, vector<Real>& J_order_2, vector<Real>& J_order_4)
+{
+    Model model (modelName);
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+
+    Timer timer_2("solver: 2nd order Feautrier");
+    timer_2.start();
+    model.compute_radiation_field_feautrier_order_2 ();
+    timer_2.stop();
+    timer_2.print();
+
+    J_order_2 = model.radiation.J.vec;
+
+    Timer timer_4("solver: 4th order Feautrier");
+    timer_4.start();
+    model.compute_radiation_field_feautrier_order_4 ();
+    timer_4.stop();
+    timer_4.print();
+
+    J_order_4 = model.radiation.J.vec;
+
+    return model.parameters.nfreqs();
+}
+
+
+///  Maximum relative difference between the mean intensities of two models
+///  with nested grids, on the points of the coarsest one
+///    @param[in] J_c    : mean intensity on the coarse grid
+///    @param[in] J_f    : mean intensity on the fine grid
+///    @param[in] nfreqs : number of frequencies
+///    @param[in] ratio  : number of fine grid points per coarse grid point
+///    @param[in] step   : stride of the compared coarse grid points
+///////////////////////////////////////////////////////////////////////////////
+double diff (const vector<Real>& J_c, const vector<Real>& J_f, const Size nfreqs, const Size ratio, const Size step)
+{
+    double diff_max = 0.0;
+
+    for (Size p = 0; p < J_c.size() / nfreqs; p += step)
+    {
+        for (Size f = 0; f < nfreqs; f++)
+        {
+            const double J_diff = fabs (J_c[p*nfreqs+f] - J_f[p*ratio*nfreqs+f]) / J_f[p*ratio*nfreqs+f];
+
+            diff_max = std::max (diff_max, J_diff);
+        }
+    }
+
+    return diff_max;
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+
+    cout << "Running test_4th_Feautrier..."                          << endl;
+    cout << "-----------------------------"                          << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    vector<Real> J_order_2;
+    vector<Real> J_order_4;
+
+    const Size nfreqs = compute_J (modelName, J_order_2, J_order_4);
+
+    double J_diff_mean = 0.0;
+    double J_diff_max  = 0.0;
+
+    for (Size i = 0; i < J_order_4.size(); i++)
+    {
+        const double J_diff = fabs (J_order_2[i] - J_order_4[i]) / J_order_4[i];
+
+        J_diff_mean += J_diff;
+        J_diff_max   = std::max (J_diff_max, J_diff);
+    }
+
+    cout << "rel. diff. J : mean = " << J_diff_mean / J_order_4.size()
+                      << "   max = " << J_diff_max                     << endl;
+
+    /// Self-convergence on three nested grids (h, h/2, h/4), given as the
+    /// model names after the first: test_feautrier_order_4 h h/2 h/4 [min_order]
+    if (argc > 3)
+    {
+        const double min_order = (argc > 4) ? atof (argv[4]) : 3.0;
+
+        vector<Real> J_order_2_h2, J_order_4_h2;
+        vector<Real> J_order_2_h4, J_order_4_h4;
+
+        compute_J (argv[2], J_order_2_h2, J_order_4_h2);
+        compute_J (argv[3], J_order_2_h4, J_order_4_h4);
+
+        // Compare on the points of the coarse grid, through the h/2 grid
+        const double err_2_h  = diff (J_order_2,    J_order_2_h2, nfreqs, 2, 1);
+        const double err_2_h2 = diff (J_order_2_h2, J_order_2_h4, nfreqs, 2, 2);
+        const double err_4_h  = diff (J_order_4,    J_order_4_h2, nfreqs, 2, 1);
+        const double err_4_h2 = diff (J_order_4_h2, J_order_4_h4, nfreqs, 2, 2);
+
+        const double order_2 = log2 (err_2_h / err_2_h2);
+        const double order_4 = log2 (err_4_h / err_4_h2);
+
+        cout << "observed order : 2nd order solver = " << order_2 << endl;
+        cout << "                 4th order solver = " << order_4 << endl;
+
+        if (!(order_4 >= min_order))
+        {
+            cout << "4th order solver converges with order below " << min_order << "!" << endl;
+
+            return (1);
+        }
+    }
+
+    cout << "Done." << endl;
+
+    return (0);
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <map>
+#include <chrono>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "model/model.hpp"
+#include "tools/numa.hpp"
+
+
+///  NUMA node on which the calling thread currently runs
+/////////////////////////////////////////////////////////
+Size get_node ()
+{
+    unsigned cpu  = 0;
+    unsigned node = 0;
+#if defined(__linux__) && defined(SYS_getcpu)
+    syscall (SYS_getcpu, &cpu, &node, nullptr);
+#endif
+    return node;
+}
+
+
+///  Stream through the point-indexed arrays (a = a + s*b) with the solver's
+///  partition of the points, and print the bandwidth per NUMA node
+///    @param[in,out] a       : array to update
+///    @param[in]     b       : array to read
+///    @param[in]     npoints : number of points
+///    @param[in]     nfreqs  : number of frequencies
+///    @param[in]     nreps   : number of passes through the arrays
+///////////////////////////////////////////////////////////////////////////
+void bandwidth (Matrix<Real>& a, const Matrix<Real>& b, const Size npoints, const Size nfreqs, const Size nreps)
+{
+    const Size nthreads = pc::multi_threading::n_threads_avail();
+
+    vector<double> seconds (nthreads, 0.0);
+    vector<double> bytes   (nthreads, 0.0);
+    vector<Size>   nodes   (nthreads, 0);
+
+#   pragma omp parallel default (shared)
+    {
+        const Size t     = pc::multi_threading::thread_id();
+        const Size start = pc::multi_threading::start (npoints);
+        const Size stop  = pc::multi_threading::stop  (npoints);
+
+        nodes[t] = get_node();
+
+        const auto begin = std::chrono::high_resolution_clock::now();
+
+        for (Size n = 0; n < nreps; n++)
+        {
+            for (Size p = start; p < stop; p++)
+            {
+                for (Size f = 0; f < nfreqs; f++)
+                {
+                    a(p,f) += 1.0e-3 * b(p,f);
+                }
+            }
+        }
+
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        seconds[t] = std::chrono::duration<double>(end - begin).count();
+        bytes  [t] = 3.0 * sizeof(Real) * nreps * (stop - start) * nfreqs;
+    }
+
+    std::map<Size, double> node_bytes;
+    std::map<Size, double> node_seconds;
+
+    for (Size t = 0; t < nthreads; t++)
+    {
+        node_bytes  [nodes[t]] += bytes[t];
+        node_seconds[nodes[t]]  = std::max (node_seconds[nodes[t]], seconds[t]);
+    }
+
+    for (const auto& nb : node_bytes)
+    {
+        cout << "  node " << nb.first << " : "
+             << nb.second / node_seconds[nb.first] / 1.0e+9 << " GB/s" << endl;
+    }
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+    const string affinity  = (argc > 2) ? argv[2] : "spread";
+
+    const Size nthreads = pc::multi_threading::n_threads_avail();
+    const Size n_pinned = set_thread_affinity (affinity);
+
+    cout << "Running test_first_touch..."     << endl;
+    cout << "---------------------------"     << endl;
+    cout << "Model name: " << modelName       << endl;
+    cout << "n threads = " << nthreads        << endl;
+    cout << "pinned    = " << n_pinned        << endl;
+
+    Model model (modelName);
+    model.compute_spectral_discretisation ();
+
+    const Size npoints = model.parameters.npoints();
+    const Size nfreqs  = model.parameters.nfreqs ();
+    const Size nreps   = 20;
+
+    Matrix<Real>& a = model.radiation.J;
+    Matrix<Real>& b = model.radiation.frequencies.nu;
+
+    /// Memory placed by the main thread (as done before by read)
+    release_pages (a.vec.data(), a.vec.size()*sizeof(Real));
+    release_pages (b.vec.data(), b.vec.size()*sizeof(Real));
+
+    for (size_t i = 0; i < a.vec.size(); i++) {a.vec[i] = 0.0;}
+    for (size_t i = 0; i < b.vec.size(); i++) {b.vec[i] = 0.0;}
+
+    model.compute_spectral_discretisation ();
+
+    cout << "main thread first touch:" << endl;
+    bandwidth (a, b, npoints, nfreqs, nreps);
+
+    const vector<Real> a_before = a.vec;
+    const vector<Real> b_before = b.vec;
+
+    /// Memory placed by the threads that use it
+    first_touch (a, 1, npoints, nfreqs);
+    first_touch (b, 1, npoints, nfreqs);
+
+    const bool preserved = (a.vec == a_before) && (b.vec == b_before);
+
+    cout << "parallel first touch:" << endl;
+    bandwidth (a, b, npoints, nfreqs, nreps);
+
+    cout << "content preserved = " << preserved << endl;
+
+    bool valid = preserved;
+
+#ifdef __linux__
+    // Every thread should have been pinned (unless no pinning was asked for)
+    valid = valid && (n_pinned == ((affinity == "none") ? 0 : nthreads));
+#endif
+
+    if (!valid)
+    {
+        cout << "First touch or thread affinity failed!" << endl;
+
+        return (1);
+    }
+
+    cout << "Done." << endl;
+
+    return (0);
+}
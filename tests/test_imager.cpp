@@ -3,6 +3,7 @@ using std::cout;
 using std::endl;
 
 #include "model/model.hpp"
+#include "solver/solver.hpp"
 #include "tools/timer.hpp"
 
 
@@ -20,11 +21,42 @@ int main (int argc, char **argv)
     model.compute_LTE_level_populations   ();
     model.compute_inverse_line_widths     ();
 
-    Timer timer("solver: 2nd order Feautrier");
-    timer.start();
-    model.compute_image (model.parameters.hnrays()-1);
-    timer.stop();
-    timer.print();
+    const Size ray_nr = model.parameters.hnrays()-1;
+
+    Solver solver;
+    solver.setup <Rest> (model);
+
+    Timer timer_2("solver: 2nd order Feautrier");
+    timer_2.start();
+    solver.image_feautrier_order_2 (model, ray_nr);
+    timer_2.stop();
+    timer_2.print();
+
+    Timer timer_1("solver: 1st order shortchar");
+    timer_1.start();
+    solver.image_shortchar_order_1 (model, ray_nr);
+    timer_1.stop();
+    timer_1.print();
+
+    /// Compare the two images
+    const vector<Real>& I_2 = model.images[0].I.vec;
+    const vector<Real>& I_1 = model.images[1].I.vec;
+
+    double diff_mean = 0.0;
+    double diff_max  = 0.0;
+
+    for (Size i = 0; i < I_2.size(); i++)
+    {
+        if (I_1[i] + I_2[i] <= 0.0) {continue;}
+
+        const double diff = fabs (I_1[i] - I_2[i]) / (I_1[i] + I_2[i]) * 2.0;
+
+        diff_mean += diff;
+        diff_max   = std::max (diff_max, diff);
+    }
+
+    cout << "rel. diff. images : mean = " << diff_mean / I_2.size()
+                           << "   max = " << diff_max               << endl;
 
     cout << "Done." << endl;
 
@@ -0,0 +1,91 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+///  Compute the converged level populations of a model
+///    @param[in,out] model : model for which to compute the level populations
+///////////////////////////////////////////////////////////////////////////////
+void compute (Model& model)
+{
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+    model.compute_level_populations       (true, 100);
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+    const Size   nmodified = (argc > 2) ? atoi (argv[2]) : 10;
+    const double tolerance = (argc > 3) ? atof (argv[3]) : 1.0E-5;
+
+    cout << "Running test_incremental..."                            << endl;
+    cout << "---------------------------"                            << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    Model model_inc (modelName);
+    Model model_ref (modelName);
+
+    compute (model_inc);
+    compute (model_ref);
+
+    // Heat the first points of the model
+    Size1 modified;
+
+    for (Size p = 0; p < nmodified; p++)
+    {
+        model_inc.thermodynamics.temperature.gas[p] *= 1.5;
+        model_ref.thermodynamics.temperature.gas[p] *= 1.5;
+
+        modified.push_back (p);
+    }
+
+    Timer timer_inc ("incremental level populations");
+    timer_inc.start();
+    model_inc.compute_level_populations_incremental (modified, 100);
+    timer_inc.stop();
+    timer_inc.print();
+
+    Timer timer_ref ("level populations from scratch");
+    timer_ref.start();
+    model_ref.compute_inverse_line_widths     ();
+    model_ref.compute_spectral_discretisation ();
+    model_ref.compute_level_populations       (true, 100);
+    timer_ref.stop();
+    timer_ref.print();
+
+    double pop_diff_max = 0.0;
+
+    for (Size l = 0; l < model_inc.parameters.nlspecs(); l++)
+    {
+        const LineProducingSpecies& lspec_inc = model_inc.lines.lineProducingSpecies[l];
+        const LineProducingSpecies& lspec_ref = model_ref.lines.lineProducingSpecies[l];
+
+        for (Size i = 0; i < lspec_ref.population.size(); i++)
+        {
+            const double pop_diff = fabs (lspec_inc.population(i) - lspec_ref.population(i))
+                                  /       lspec_ref.population(i);
+
+            pop_diff_max = std::max (pop_diff_max, pop_diff);
+        }
+    }
+
+    cout << "rel. diff. populations : max = " << pop_diff_max << endl;
+
+    if (pop_diff_max > tolerance)
+    {
+        cout << "Incremental populations differ by more than " << tolerance << "!" << endl;
+
+        return (1);
+    }
+
+    cout << "Done." << endl;
+
+    return (0);
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+///  Compute the level populations of a model, with the given ALO pruning
+///    @param[in,out] model       : model for which to compute the level populations
+///    @param[in]     threshold   : relative threshold for the off-diagonal ALO elements
+///    @param[in]     max_entries : maximum number of ALO elements per point and transition
+///    @return number of iterations
+/////////////////////////////////////////////////////////////////////////////////////////
+int compute (Model& model, const double threshold, const long max_entries)
+{
+    model.parameters.lambda_threshold   = threshold;
+    model.parameters.lambda_max_entries = max_entries;
+
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+
+    Timer timer ("level populations (threshold = " + to_string (threshold)
+                                 + ", max entries = " + to_string (max_entries) + ")");
+    timer.start();
+    const int niterations = model.compute_level_populations (true, 100);
+    timer.stop();
+    timer.print();
+
+    return niterations;
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName   = argv[1];
+    const long   n_off_diag  = (argc > 2) ? atoi (argv[2]) : 4;
+    const double threshold   = (argc > 3) ? atof (argv[3]) : 1.0e-2;
+    const long   max_entries = (argc > 4) ? atoi (argv[4]) : 0;
+    const double tolerance   = (argc > 5) ? atof (argv[5]) : 1.0e-3;
+
+    cout << "Running test_lambda_pruning..."                         << endl;
+    cout << "-------------------------------"                        << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    Model model_ref (modelName);
+    Model model_prn (modelName);
+
+    model_ref.parameters.n_off_diag = n_off_diag;
+    model_prn.parameters.n_off_diag = n_off_diag;
+
+    const int niterations_ref = compute (model_ref, 0.0,       0          );
+    const int niterations_prn = compute (model_prn, threshold, max_entries);
+
+    double pop_diff_max = 0.0;
+    Index  n_dropped    = 0;
+
+    for (Size l = 0; l < model_ref.parameters.nlspecs(); l++)
+    {
+        const LineProducingSpecies& lspec_ref = model_ref.lines.lineProducingSpecies[l];
+        const LineProducingSpecies& lspec_prn = model_prn.lines.lineProducingSpecies[l];
+
+        cout << "reference : "; lspec_ref.lambda.print_statistics();
+        cout << "pruned    : "; lspec_prn.lambda.print_statistics();
+
+        n_dropped += lspec_prn.lambda.get_n_dropped();
+
+        for (Size i = 0; i < lspec_ref.population.size(); i++)
+        {
+            const double pop_diff = fabs (lspec_prn.population(i) - lspec_ref.population(i))
+                                  /       lspec_ref.population(i);
+
+            pop_diff_max = std::max (pop_diff_max, pop_diff);
+        }
+    }
+
+    cout << "iterations : reference = " << niterations_ref
+         <<            ", pruned = "    << niterations_prn << endl;
+    cout << "rel. diff. populations : max = " << pop_diff_max << endl;
+
+    /// Pruning should drop elements, without changing the populations much
+    const bool pruned   = (n_dropped    > 0);
+    const bool accurate = (pop_diff_max < tolerance);
+
+    cout << "pruned = " << pruned << ", accurate = " << accurate << endl;
+
+    cout << "Done." << endl;
+
+    return ((pruned && accurate) ? 0 : 1);
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "io/cpp/io_cpp_text.hpp"
+#include "io/python/io_python.hpp"
+
+
+///  Check whether two Eigen vectors are bitwise identical
+//////////////////////////////////////////////////////////
+bool equal (const VectorXr& a, const VectorXr& b)
+{
+    if (a.size() != b.size()) {return false;}
+
+    for (Index i = 0; i < a.size(); i++)
+    {
+        if (a[i] != b[i]) {return false;}
+    }
+
+    return true;
+}
+
+
+///  Read a model from an hdf5 file, or else from a model in text format (which
+///  is thread safe, so then the model sections are read concurrently)
+///    @param[out] model     : model to read
+///    @param[in]  modelName : name of the model (file)
+///    @param[in]  lazy      : true to defer reading the optional data
+///////////////////////////////////////////////////////////////////////////////
+void read (Model& model, const string& modelName, const bool lazy)
+{
+    const string extension = ".hdf5";
+
+    const bool hdf5 = (modelName.size() > extension.size())
+                   && (modelName.compare (modelName.size()-extension.size(), extension.size(), extension) == 0);
+
+    if (hdf5) {model.read (IoPython ("hdf5", modelName), lazy);}
+    else      {model.read (IoText   (        modelName), lazy);}
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+    const Size   nthreads  = pc::multi_threading::n_threads_avail();
+
+    cout << "Running test_model_read..."                             << endl;
+    cout << "--------------------------"                             << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << nthreads                               << endl;
+
+    // The model sections are read concurrently with more than one thread
+    pc::multi_threading::set_n_threads_avail (1);
+    Model model_1;
+    read (model_1, modelName, false);
+
+    pc::multi_threading::set_n_threads_avail (nthreads);
+    Model model_n;
+    read (model_n, modelName, false);
+
+    Model model_l;
+    read (model_l, modelName, true);
+    model_l.lines.read_deferred_data ();
+
+    bool identical = true;
+
+    for (const Model* model : {&model_n, &model_l})
+    {
+        identical = identical && (model_1.thermodynamics.temperature.gas.vec == model->thermodynamics.temperature.gas.vec)
+                              && (model_1.chemistry.species.abundance.vec    == model->chemistry.species.abundance.vec   );
+
+        for (Size l = 0; l < model_1.parameters.nlspecs(); l++)
+        {
+            const LineProducingSpecies& lspec_1 = model_1.lines.lineProducingSpecies[l];
+            const LineProducingSpecies& lspec_n = model ->lines.lineProducingSpecies[l];
+
+            identical = identical && equal (lspec_1.population,       lspec_n.population      )
+                                  && equal (lspec_1.population_prev1, lspec_n.population_prev1)
+                                  && equal (lspec_1.population_prev2, lspec_n.population_prev2)
+                                  && equal (lspec_1.population_prev3, lspec_n.population_prev3)
+                                  && (lspec_1.population_tot == lspec_n.population_tot)
+                                  && (lspec_1.Jlin.vec       == lspec_n.Jlin.vec      )
+                                  && (lspec_1.Jeff.vec       == lspec_n.Jeff.vec      );
+        }
+    }
+
+    cout << "bitwise identical = " << identical << endl;
+
+    cout << "Done." << endl;
+
+    return (identical ? 0 : 1);
+}
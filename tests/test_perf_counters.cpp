@@ -0,0 +1,59 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+#include "tools/perf_counters.hpp"
+
+
+int main (int argc, char **argv)
+{
+    const string modelName       = argv[1];
+    const long   max_niterations = (argc > 2) ? atol (argv[2]) : 3;
+
+    cout << "Running test_perf_counters..."                          << endl;
+    cout << "-----------------------------"                          << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+    cout << "enabled   = " << perf_counters_enabled()                << endl;
+
+    Model model (modelName);
+    model.compute_spectral_discretisation ();
+    model.compute_inverse_line_widths     ();
+    model.compute_LTE_level_populations   ();
+
+    reset_perf_counters ();
+
+    Timer timer ("level populations");
+    timer.start();
+    model.compute_level_populations (false, max_niterations);
+    timer.stop();
+
+    timer.print();
+    print_perf_report (true);
+
+    /// With the counters, every phase should have been measured
+    bool measured = true;
+
+    if (perf_counters_enabled())
+    {
+        for (Size ph = 0; ph < PERF_NPHASES; ph++)
+        {
+            uint64_t calls = 0;
+
+            for (Size t = 0; t < perf_threads().contents.size(); t++)
+            {
+                calls += perf_threads()(t).calls[ph];
+            }
+
+            measured = measured && (calls > 0);
+        }
+    }
+
+    cout << "all phases measured = " << measured << endl;
+
+    cout << "Done." << endl;
+
+    return (measured ? 0 : 1);
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+///  Compute the level populations of a model
+///    @param[in,out] model : model for which to compute the level populations
+///////////////////////////////////////////////////////////////////////////////
+void compute (Model& model)
+{
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+
+    Timer timer ("level populations (" + to_string (pc::multi_threading::n_threads_avail()) + " threads)");
+    timer.start();
+    model.compute_level_populations (true, 100);
+    timer.stop();
+    timer.print();
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+    const Size   nthreads  = pc::multi_threading::n_threads_avail();
+
+    cout << "Running test_reproducibility..."                        << endl;
+    cout << "--------------------------------"                       << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << nthreads                               << endl;
+
+    pc::multi_threading::set_n_threads_avail (1);
+    Model model_1 (modelName);
+    compute (model_1);
+
+    pc::multi_threading::set_n_threads_avail (nthreads);
+    Model model_n (modelName);
+    compute (model_n);
+
+    bool identical = (model_1.radiation.J.vec == model_n.radiation.J.vec);
+
+    for (Size l = 0; l < model_1.parameters.nlspecs(); l++)
+    {
+        const LineProducingSpecies& lspec_1 = model_1.lines.lineProducingSpecies[l];
+        const LineProducingSpecies& lspec_n = model_n.lines.lineProducingSpecies[l];
+
+        for (Size i = 0; i < lspec_1.population.size(); i++)
+        {
+            identical = identical && (lspec_1.population(i) == lspec_n.population(i));
+        }
+
+        identical = identical && (lspec_1.lambda.Ls == lspec_n.lambda.Ls)
+                              && (lspec_1.lambda.nr == lspec_n.lambda.nr);
+    }
+
+    cout << "bitwise identical = " << identical << endl;
+
+    cout << "Done." << endl;
+
+    return (identical ? 0 : 1);
+}
@@ -26,6 +26,38 @@ int main (int argc, char **argv)
     timer.stop();
     timer.print();
 
+    model.parameters.store_intensities = false;
+
+    Timer timer_no_I("solver: short characteristics without I");
+    timer_no_I.start();
+    model.compute_radiation_field_shortchar_order_0 ();
+    timer_no_I.stop();
+    timer_no_I.print();
+
+    const vector<Real> J_shortchar = model.radiation.J.vec;
+
+    Timer timer_feautrier("solver: 2nd order Feautrier");
+    timer_feautrier.start();
+    model.compute_radiation_field_feautrier_order_2 ();
+    timer_feautrier.stop();
+    timer_feautrier.print();
+
+    const vector<Real> J_feautrier = model.radiation.J.vec;
+
+    double J_diff_mean = 0.0;
+    double J_diff_max  = 0.0;
+
+    for (Size i = 0; i < J_feautrier.size(); i++)
+    {
+        const double J_diff = fabs (J_shortchar[i] - J_feautrier[i]) / J_feautrier[i];
+
+        J_diff_mean += J_diff;
+        J_diff_max   = std::max (J_diff_max, J_diff);
+    }
+
+    cout << "rel. diff. J : mean = " << J_diff_mean / J_feautrier.size()
+                      << "   max = " << J_diff_max                       << endl;
+
     cout << "Done." << endl;
 
     return (0);
@@ -14,19 +14,21 @@ using std::sqrt;
 
 MatrixXr setup_T (Solver& solver)
 {
-    const Size N = solver.n_tot_();
+    Scratch& scratch = solver.scratch_();
+
+    const Size N = scratch.n_tot;
     cout << "N = " << N << endl;
 
-    Vector<Real>& A = solver.A_();
-    Vector<Real>& C = solver.C_();
+    Vector<Real>& A = scratch.A;
+    Vector<Real>& C = scratch.C;
 
-    cout << "solver.A_()[10] = " << solver.A_()[10] << endl;
-    cout << "       A   [10] = " << A[10] << endl;
-    cout << "solver.C_()[10] = " << solver.C_()[10] << endl;
-    cout << "       C   [10] = " << C[10] << endl;
+    cout << "scratch.A[10] = " << scratch.A[10] << endl;
+    cout << "        A[10] = " << A[10] << endl;
+    cout << "scratch.C[10] = " << scratch.C[10] << endl;
+    cout << "        C[10] = " << C[10] << endl;
 
-    const Size first = solver.first_();
-    const Size last  = solver.last_ ();
+    const Size first = scratch.first;
+    const Size last  = scratch.last;
     cout << "first = " << first << endl;
     cout << "last  = " << last  << endl;
 
@@ -55,14 +57,16 @@ MatrixXr setup_T (Solver& solver)
 
 MatrixXr setup_L (Solver& solver)
 {
-    const Size N = solver.n_tot_();
+    Scratch& scratch = solver.scratch_();
+
+    const Size N = scratch.n_tot;
 
-    Vector<Real>& L_diag  = solver.L_diag_ ();
-    Matrix<Real>& L_upper = solver.L_upper_();
-    Matrix<Real>& L_lower = solver.L_lower_();
+    Vector<Real>& L_diag  = scratch.L_diag;
+    Matrix<Real>& L_upper = scratch.L_upper;
+    Matrix<Real>& L_lower = scratch.L_lower;
 
-    const Size first = solver.first_();
-    const Size last  = solver.last_ ();
+    const Size first = scratch.first;
+    const Size last  = scratch.last;
 
     MatrixXr L = MatrixXr::Zero (N, N);
 
@@ -142,6 +146,7 @@ TEST (solver_lambda, lambda)
     model.parameters.n_off_diag = model.parameters.npoints();
 
     Solver solver;
+    solver.full_lambda = true;
     solver.setup <CoMoving>        (model);
     solver.solve_feautrier_order_2 (model);
 
@@ -162,6 +167,60 @@ TEST (solver_lambda, lambda)
 }
 
 
+TEST (solver_lambda, centre_row)
+{
+    const string modelFile = magritte_folder + "/tests/models/density_distribution_VZa_1D.hdf5";
+
+    Model model = Model (modelFile);
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+
+    model.parameters.n_off_diag = 3;
+
+    // Reference: Lambda elements extracted from the complete inverse
+    Solver solver_full;
+    solver_full.full_lambda = true;
+    solver_full.setup <CoMoving>        (model);
+    solver_full.solve_feautrier_order_2 (model);
+
+    vector<Lambda> lambda_full;
+
+    for (const LineProducingSpecies& lspec : model.lines.lineProducingSpecies)
+    {
+        lambda_full.push_back (lspec.lambda);
+    }
+
+    // Lambda elements from the centre-targeted elimination
+    Solver solver_centre;
+    solver_centre.setup <CoMoving>        (model);
+    solver_centre.solve_feautrier_order_2 (model);
+
+    for (Size l = 0; l < model.parameters.nlspecs(); l++)
+    {
+        const Lambda& full   = lambda_full[l];
+        const Lambda& centre = model.lines.lineProducingSpecies[l].lambda;
+
+        for (Size p = 0; p < model.parameters.npoints(); p++)
+        {
+            for (Size k = 0; k < full.nrad; k++)
+            {
+                ASSERT_EQ (centre.get_size(p,k), full.get_size(p,k));
+
+                for (Size m = 0; m < full.get_size(p,k); m++)
+                {
+                    const double Ls_full   = full  .get_Ls(p,k,m);
+                    const double Ls_centre = centre.get_Ls(p,k,m);
+
+                    EXPECT_EQ   (centre.get_nr(p,k,m), full.get_nr(p,k,m));
+                    EXPECT_NEAR (Ls_centre, Ls_full, 1.0e-12 * fabs (Ls_full));
+                }
+            }
+        }
+    }
+}
+
+
 int main (int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,167 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "solver/solver.hpp"
+#include "tools/timer.hpp"
+
+
+///  Trace a ray through the geometry (with the currently selected tracer)
+///    @param[in]  o : number of cell from which the ray originates
+///    @param[in]  r : number of the ray along which we are looking
+///    @param[out] Z : distance along the ray to its last point
+///    @return points on the ray, in order
+///////////////////////////////////////////////////////////////////////
+Size1 trace (const Geometry& geometry, const Size o, const Size r, double& Z)
+{
+    Size1 ray;
+
+    double dZ = 0.0;
+           Z  = 0.0;
+
+    Size nxt = geometry.get_next (o, r, o, Z, dZ);
+
+    while (geometry.valid_point (nxt))
+    {
+        ray.push_back (nxt);
+
+        if (!geometry.not_on_boundary (nxt)) {break;}
+
+        nxt = geometry.get_next (o, r, nxt, Z, dZ);
+    }
+
+    return ray;
+}
+
+
+int main (int argc, char **argv)
+{
+    const string modelName = argv[1];
+    const double tolerance = (argc > 2) ? atof (argv[2]) : 1.0E-6;
+
+    cout << "Running test_successor_graph..."                        << endl;
+    cout << "-------------------------------"                        << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    Model model (modelName);
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+
+    Geometry& geometry = model.geometry;
+
+    const Size npoints = model.parameters.npoints();
+    const Size nrays   = model.parameters.nrays();
+
+    Solver solver;
+
+    /// Speed: ray lengths for all origins and directions
+    Timer timer_exact ("exact tracer      ");
+    timer_exact.start();
+    solver.get_ray_lengths <CoMoving> (model);
+    timer_exact.stop();
+
+    const vector<Size> lengths_exact = geometry.lengths.vec;
+
+    Timer timer_setup ("successor graph   ");
+    timer_setup.start();
+    geometry.set_successors ();
+    timer_setup.stop();
+
+    Timer timer_approx ("approximate tracer");
+    timer_approx.start();
+    solver.get_ray_lengths <CoMoving> (model);
+    timer_approx.stop();
+
+    timer_exact .print();
+    timer_setup .print();
+    timer_approx.print();
+
+    cout << "successor graph memory = "
+         << nrays*npoints*(sizeof(Size) + sizeof(float)) / 1.0e+6 << " MB" << endl;
+
+    /// Accuracy: compare the traced rays
+    Size   n_identical      = 0;
+    Size   n_same_boundary  = 0;
+    double length_diff_mean = 0.0;
+    double length_diff_max  = 0.0;
+    double Z_diff_mean      = 0.0;
+    double Z_diff_max       = 0.0;
+
+    for (Size o = 0; o < npoints; o++)
+    {
+        for (Size r = 0; r < nrays; r++)
+        {
+            double Z_exact, Z_approx;
+
+            geometry.use_successors = false;
+            const Size1 ray_exact  = trace (geometry, o, r, Z_exact);
+            geometry.use_successors = true;
+            const Size1 ray_approx = trace (geometry, o, r, Z_approx);
+
+            if (ray_exact == ray_approx) {n_identical++;}
+
+            if (ray_exact.empty())
+            {
+                if (ray_approx.empty()) {n_same_boundary++;}
+                continue;
+            }
+
+            if (!ray_approx.empty() && (ray_exact.back() == ray_approx.back())) {n_same_boundary++;}
+
+            const double length_diff = fabs ((double) ray_approx.size() - (double) ray_exact.size()) / ray_exact.size();
+            const double      Z_diff = fabs (Z_approx - Z_exact) / Z_exact;
+
+            length_diff_mean += length_diff;
+            Z_diff_mean      +=      Z_diff;
+
+            length_diff_max = std::max (length_diff_max, length_diff);
+                 Z_diff_max = std::max (     Z_diff_max,      Z_diff);
+        }
+    }
+
+    const double n_total = npoints * nrays;
+
+    cout << "identical rays         = " << n_identical     / n_total << endl;
+    cout << "same boundary point    = " << n_same_boundary / n_total << endl;
+    cout << "rel. diff. #points     : mean = " << length_diff_mean / n_total
+                                << "   max = " << length_diff_max            << endl;
+    cout << "rel. diff. ray length  : mean = " << Z_diff_mean / n_total
+                                << "   max = " << Z_diff_max                 << endl;
+
+    /// Accuracy: compare the resulting mean intensities
+    geometry.use_successors = false;
+    model.compute_radiation_field_feautrier_order_2 ();
+    const vector<Real> J_exact = model.radiation.J.vec;
+
+    geometry.use_successors = true;
+    model.compute_radiation_field_feautrier_order_2 ();
+    const vector<Real> J_approx = model.radiation.J.vec;
+
+    double J_diff_mean = 0.0;
+    double J_diff_max  = 0.0;
+
+    for (Size i = 0; i < J_exact.size(); i++)
+    {
+        const double J_diff = fabs (J_approx[i] - J_exact[i]) / J_exact[i];
+
+        J_diff_mean += J_diff;
+        J_diff_max   = std::max (J_diff_max, J_diff);
+    }
+
+    cout << "rel. diff. J           : mean = " << J_diff_mean / J_exact.size()
+                                << "   max = " << J_diff_max                 << endl;
+
+    if ((n_same_boundary < n_total) || (Z_diff_max > tolerance) || (J_diff_max > tolerance))
+    {
+        cout << "Approximate rays differ from the exact ones by more than " << tolerance << "!" << endl;
+
+        return (1);
+    }
+
+    cout << "Done." << endl;
+
+    return (0);
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+int main (int argc, char **argv)
+{
+    const string modelName       = argv[1];
+    const double tolerance       = (argc > 2) ? atof (argv[2]) : 1.0e-2;
+    const long   max_niterations = (argc > 3) ? atol (argv[3]) : 10;
+    const Size   subsample       = (argc > 4) ? atol (argv[4]) : 4;
+
+    cout << "Running test_tune_parameters..."                        << endl;
+    cout << "-------------------------------"                        << endl;
+    cout << "Model name: " << modelName                              << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    Model model (modelName);
+    model.compute_spectral_discretisation ();
+    model.compute_inverse_line_widths     ();
+    model.compute_LTE_level_populations   ();
+
+    const VectorXr population_0 = model.lines.lineProducingSpecies[0].population;
+    const Real     emissivity_0 = model.lines.emissivity(0,0);
+
+    Timer timer ("tuning");
+    timer.start();
+    const int ntrials = model.tune_solver_parameters (tolerance, max_niterations, subsample);
+    timer.stop();
+    timer.print();
+
+    cout << "trial solves = " << ntrials << endl;
+
+    /// The proposed configuration should never be more expensive than the model
+    const bool valid = (model.parameters.tuned_nquads >  0                          )
+                    && (model.parameters.tuned_nquads <= model.parameters.nquads())
+                    && (model.parameters.tuned_nrays  >  0                          )
+                    && (model.parameters.tuned_nrays  <= model.parameters.nrays ());
+
+    /// The model should be left in the state it was in before tuning
+    const bool restored = (model.lines.lineProducingSpecies[0].population == population_0)
+                       && (model.lines.emissivity(0,0)                   == emissivity_0);
+
+    cout << "valid proposal = " << valid    << endl;
+    cout << "model restored = " << restored << endl;
+
+    cout << "Done." << endl;
+
+    return ((valid && restored) ? 0 : 1);
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+using std::cout;
+using std::endl;
+
+#include "model/model.hpp"
+#include "tools/timer.hpp"
+
+
+///  Prepare a model for the computation of its level populations
+///    @param[in,out] model : model to prepare
+/////////////////////////////////////////////////////////////////
+void prepare (Model& model)
+{
+    model.compute_spectral_discretisation ();
+    model.compute_LTE_level_populations   ();
+    model.compute_inverse_line_widths     ();
+}
+
+
+int main (int argc, char **argv)
+{
+    const string sourceName = argv[1];
+    const string targetName = argv[2];
+    const double tolerance  = (argc > 3) ? atof (argv[3]) : 1.0E-5;
+
+    cout << "Running test_warm_start..."                             << endl;
+    cout << "--------------------------"                             << endl;
+    cout << "Source model name: " << sourceName                      << endl;
+    cout << "Target model name: " << targetName                      << endl;
+    cout << "n threads = " << pc::multi_threading::n_threads_avail() << endl;
+
+    // The source model has to be solved before the target is read
+    Model source (sourceName);
+    prepare (source);
+    source.compute_level_populations (true, 100);
+
+    Model target_lte (targetName);
+    prepare (target_lte);
+
+    Timer timer_lte ("level populations from LTE");
+    timer_lte.start();
+    const int iterations_lte = target_lte.compute_level_populations (true, 100);
+    timer_lte.stop();
+    timer_lte.print();
+
+    Model target_int (targetName);
+    prepare (target_int);
+
+    Timer timer_int ("level populations from interpolation");
+    timer_int.start();
+    target_int.compute_level_populations_from_model (source, 8);
+    const int iterations_int = target_int.compute_level_populations (true, 100);
+    timer_int.stop();
+    timer_int.print();
+
+    cout << "iterations from LTE           = " << iterations_lte                  << endl;
+    cout << "iterations from interpolation = " << iterations_int                  << endl;
+    cout << "iterations saved              = " << iterations_lte - iterations_int << endl;
+
+    double pop_diff_max = 0.0;
+
+    for (Size l = 0; l < target_lte.parameters.nlspecs(); l++)
+    {
+        const LineProducingSpecies& lspec_lte = target_lte.lines.lineProducingSpecies[l];
+        const LineProducingSpecies& lspec_int = target_int.lines.lineProducingSpecies[l];
+
+        for (Size i = 0; i < lspec_lte.population.size(); i++)
+        {
+            const double pop_diff = fabs (lspec_int.population(i) - lspec_lte.population(i))
+                                  /       lspec_lte.population(i);
+
+            pop_diff_max = std::max (pop_diff_max, pop_diff);
+        }
+    }
+
+    cout << "rel. diff. populations : max = " << pop_diff_max << endl;
+
+    if ((iterations_int >= iterations_lte) || (pop_diff_max > tolerance))
+    {
+        cout << "Warm start did not save iterations or converged elsewhere!" << endl;
+
+        return (1);
+    }
+
+    cout << "Done." << endl;
+
+    return (0);
+}